@@ -0,0 +1,270 @@
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+#include "src/v2/Reflectable.h"
+#include "src/v2/BatchSerializer.h"
+#include "src/v2/IterativeJsonSerializer.h"
+#include "src/v2/ParallelSerializer.h"
+#include "src/v2/ParallelDeserializer.h"
+
+using namespace yuri;
+using namespace std;
+
+struct Record : public Reflectable<Record> {
+  int ReflectField(id);
+  string ReflectField(name);
+  double ReflectField(price);
+  int ReflectField(quantity);
+  string ReflectField(category);
+  string ReflectField(description);
+  long ReflectField(timestamp);
+  bool ReflectField(enabled);
+  string ReflectField(routing_key);
+  double ReflectField(weight);
+  vector<int> ReflectField(tags);
+  string ReflectField(owner);
+};
+
+// 运行f共iterations次，返回每次的平均耗时（纳秒）
+template<typename F>
+double measure(size_t iterations, F &&f) {
+  auto begin = chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i) f(i);
+  auto end = chrono::steady_clock::now();
+  return chrono::duration<double, nano>(end - begin).count() / iterations;
+}
+
+void benchFieldLookup() {
+  constexpr size_t iterations = 20000000;
+  vector<string> keys;
+  for (auto &info : Record().getFieldInfoList()) keys.emplace_back(info.name);
+  keys.emplace_back("unknown");
+  keys.emplace_back("price_");
+  // 预先生成查询序列，避免取模运算干扰计时
+  vector<string_view> views(1024);
+  for (size_t i = 0; i < views.size(); ++i) views[i] = keys[(i * 7) % keys.size()];
+  // 原先ReflectInfo中的nameToOffset
+  unordered_map<string_view, size_t> nameToOffset;
+  for (auto &info : Record().getFieldInfoList()) nameToOffset[info.name] = info.offset;
+  size_t sink = 0;
+  auto mapTime = measure(iterations, [&](size_t i) {
+    auto it = nameToOffset.find(views[i % views.size()]);
+    sink += it == nameToOffset.end() ? 0 : it->second;
+  });
+  auto indexTime = measure(iterations, [&](size_t i) {
+    auto info = Record::getFieldInfo(views[i % views.size()]);
+    sink += info == nullptr ? 0 : info->offset;
+  });
+  cout << "field lookup: unordered_map " << mapTime << " ns, FieldNameIndex " << indexTime << " ns ("
+       << mapTime / indexTime << "x)" << endl;
+  if (sink == 42) cout << sink << endl;
+}
+
+Record makeRecord(int i) {
+  Record record;
+  record.id = i;
+  record.name = "record-" + to_string(i);
+  record.price = i * 0.25;
+  record.quantity = i % 100;
+  record.category = "category";
+  record.description = "a moderately long description of the record";
+  record.timestamp = 1600000000000L + i;
+  record.enabled = i % 2 == 0;
+  record.routing_key = "eu-west.orders";
+  record.weight = 1.5;
+  record.tags = {1, 2, 3, i};
+  record.owner = "sora";
+  return record;
+}
+
+void benchBinary() {
+  constexpr size_t iterations = 200000;
+  auto record = makeRecord(12345);
+  size_t sink = 0;
+  auto json = JsonSerializer().serialize(record);
+  auto binary = BinarySerializer().serialize(record);
+  auto jsonEncode = measure(iterations, [&](size_t) { sink += JsonSerializer().serialize(record).size(); });
+  auto binaryEncode = measure(iterations, [&](size_t) { sink += BinarySerializer().serialize(record).size(); });
+  auto jsonDecode = measure(iterations, [&](size_t) {
+    sink += JsonDeserializer().deserialize<Record>(json).id;
+  });
+  auto binaryDecode = measure(iterations, [&](size_t) {
+    sink += BinaryDeserializer().deserialize<Record>(binary).id;
+  });
+  cout << "payload: json " << json.size() << " bytes, binary " << binary.size() << " bytes" << endl;
+  cout << "encode: json " << jsonEncode << " ns, binary " << binaryEncode << " ns (" << jsonEncode / binaryEncode
+       << "x)" << endl;
+  cout << "decode: json " << jsonDecode << " ns, binary " << binaryDecode << " ns (" << jsonDecode / binaryDecode
+       << "x)" << endl;
+  if (sink == 42) cout << sink << endl;
+}
+
+void benchBatch() {
+  constexpr size_t batches = 200;
+  vector<Record> records;
+  for (int i = 0; i < 1000; ++i) records.push_back(makeRecord(i));
+  size_t sink = 0;
+  auto single = measure(batches, [&](size_t) {
+    for (auto &record : records) sink += JsonSerializer().serialize(record).size();
+  });
+  BatchSerializer<> lines;
+  auto batch = measure(batches, [&](size_t) { sink += lines.serialize(records).size(); });
+  auto perSecond = [&](double ns) { return records.size() / (ns / 1e9); };
+  cout << "batch: per-object " << perSecond(single) << " records/s, ndjson batch " << perSecond(batch)
+       << " records/s (" << single / batch << "x)" << endl;
+  if (sink == 42) cout << sink << endl;
+}
+
+void benchParallel() {
+  constexpr size_t iterations = 5;
+  vector<Record> records;
+  for (int i = 0; i < 200000; ++i) records.push_back(makeRecord(i));
+  size_t sink = 0;
+  BatchSerializer<> batch;
+  auto single = measure(iterations, [&](size_t) { sink += batch.serialize(records).size(); });
+  cout << "parallel: 1 thread " << records.size() / (single / 1e9) << " records/s";
+  for (size_t threads = 2; threads <= thread::hardware_concurrency(); threads *= 2) {
+    ParallelSerializer<> parallel(BatchFormat::Lines, threads);
+    auto time = measure(iterations, [&](size_t) { sink += parallel.serialize(records).size(); });
+    cout << ", " << threads << " threads " << single / time << "x";
+  }
+  cout << endl;
+  if (sink == 42) cout << sink << endl;
+}
+
+void benchParallelIngest() {
+  constexpr size_t iterations = 5;
+  vector<Record> records;
+  for (int i = 0; i < 200000; ++i) records.push_back(makeRecord(i));
+  size_t sink = 0;
+  for (auto format : {BatchFormat::Lines, BatchFormat::Array}) {
+    string input(BatchSerializer<>(format).serialize(records));
+    ParallelDeserializer<Record> serial(format, 1);
+    auto single = measure(iterations, [&](size_t) { sink += serial.deserialize(input).size(); });
+    cout << "ingest " << (format == BatchFormat::Lines ? "lines" : "array") << ": 1 thread "
+         << input.size() / (single / 1e9) / 1e6 << " MB/s";
+    for (size_t threads = 2; threads <= thread::hardware_concurrency(); threads *= 2) {
+      ParallelDeserializer<Record> parallel(format, threads);
+      auto time = measure(iterations, [&](size_t) { sink += parallel.deserialize(input).size(); });
+      cout << ", " << threads << " threads " << single / time << "x";
+    }
+    cout << endl;
+  }
+  if (sink == 42) cout << sink << endl;
+}
+
+struct Samples : public Reflectable<Samples> {
+  vector<double> ReflectField(values);
+  vector<int> ReflectField(counts);
+};
+
+void benchNumericBlock() {
+  constexpr size_t iterations = 50;
+  Samples samples;
+  for (int i = 0; i < 1 << 20; ++i) {
+    samples.values.push_back(i * 0.5);
+    samples.counts.push_back(i);
+  }
+  size_t sink = 0;
+  auto binary = BinarySerializer().serialize(samples);
+  auto encode = measure(iterations, [&](size_t) { sink += BinarySerializer().serialize(samples).size(); });
+  auto decode = measure(iterations, [&](size_t) {
+    sink += BinaryDeserializer().deserialize<Samples>(binary).counts.size();
+  });
+  auto megabytes = binary.size() / 1e6;
+  cout << "numeric block: " << megabytes << " MB, encode " << megabytes / (encode / 1e9) << " MB/s, decode "
+       << megabytes / (decode / 1e9) << " MB/s" << endl;
+  if (sink == 42) cout << sink << endl;
+}
+
+void benchNumberFormat() {
+  constexpr size_t iterations = 50;
+  Samples samples;
+  for (int i = 0; i < 1 << 16; ++i) {
+    samples.values.push_back(i * 0.37 + 1e-3);
+    samples.counts.push_back(i * 7919);
+  }
+  size_t sink = 0;
+  // 原先的operator<<路径
+  auto stream = measure(iterations, [&](size_t) {
+    ostringstream ss;
+    ss.precision(17);
+    for (auto value : samples.values) ss << value << ',';
+    for (auto count : samples.counts) ss << count << ',';
+    sink += ss.str().size();
+  });
+  auto json = measure(iterations, [&](size_t) { sink += JsonSerializer().serialize(samples).size(); });
+  auto numbers = samples.values.size() + samples.counts.size();
+  cout << "number format: ostream " << stream / numbers << " ns/number, to_chars " << json / numbers
+       << " ns/number (" << stream / json << "x)" << endl;
+  if (sink == 42) cout << sink << endl;
+}
+
+void benchEscape() {
+  constexpr size_t iterations = 2000;
+  string text;
+  for (int i = 0; i < 4096; ++i) text += i % 64 == 0 ? "say \"hi\"\n" : "plain text ";
+  OutputBuffer buffer;
+  auto scalar = measure(iterations, [&](size_t) {
+    buffer.clear();
+    detail::escapeJsonScalar(buffer, text.data(), text.size());
+  });
+  auto dispatched = measure(iterations, [&](size_t) {
+    buffer.clear();
+    escapeJsonString(buffer, text);
+  });
+  auto megabytes = text.size() / 1e6;
+  cout << "escape: scalar " << megabytes / (scalar / 1e9) << " MB/s, simd " << megabytes / (dispatched / 1e9)
+       << " MB/s" << endl;
+}
+
+struct Link : public Reflectable<Link> {
+  int ReflectField(value);
+  unique_ptr<Link> ReflectField(next);
+};
+
+// 逐个释放，避免unique_ptr链的析构本身递归过深
+void releaseChain(Link &head) {
+  auto next = std::move(head.next);
+  while (next != nullptr) next = std::move(next->next);
+}
+
+void benchDepth() {
+  IterativeJsonSerializer iterative;
+  size_t sink = 0;
+  cout << "depth:";
+  for (size_t depth : {10, 1000, 100000, 1000000}) {
+    Link head;
+    Link *tail = &head;
+    for (size_t i = 0; i < depth; ++i) {
+      tail->next = make_unique<Link>();
+      tail = tail->next.get();
+      tail->value = static_cast<int>(i);
+    }
+    size_t iterations = max<size_t>(1, 1000000 / depth);
+    auto iterativeTime = measure(iterations, [&](size_t) { sink += iterative.serialize(head).size(); });
+    cout << " " << depth << " levels iterative " << iterativeTime / depth << " ns/level";
+    // 递归版本在更深的层数会栈溢出
+    if (depth <= 1000) {
+      auto recursiveTime = measure(iterations, [&](size_t) { sink += JsonSerializer().serialize(head).size(); });
+      cout << " recursive " << recursiveTime / depth << " ns/level";
+    }
+    cout << ";";
+    releaseChain(head);
+  }
+  cout << endl;
+  if (sink == 42) cout << sink << endl;
+}
+
+int main() {
+  benchFieldLookup();
+  benchBinary();
+  benchBatch();
+  benchParallel();
+  benchParallelIngest();
+  benchNumericBlock();
+  benchNumberFormat();
+  benchEscape();
+  benchDepth();
+}
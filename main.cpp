@@ -1,6 +1,9 @@
+#include <deque>
 #include <iostream>
+#include <list>
 #include <unordered_set>
 #include "src/v2/Reflectable.h"
+#include "src/v2/IterativeJsonSerializer.h"
 
 // 引入命名空间
 using namespace yuri;
@@ -29,6 +32,17 @@ struct B : public Reflectable<B> {
   A ReflectField(a);
 };
 
+struct Numbers : public Reflectable<Numbers> {
+  int ReflectField(i, = 0);
+  double ReflectField(d, = 0);
+};
+
+// deque的迭代器放不进IterativeJsonOutput的帧中
+struct Queues : public Reflectable<Queues> {
+  std::deque<std::deque<int>> ReflectField(deque);
+  std::list<Numbers> ReflectField(list);
+};
+
 int main() {
   A a;
   // 遍历字段
@@ -53,5 +67,36 @@ int main() {
   output(a);
   B b;
   cout << b.toString() << endl;
-  cout << JsonSerializer().serialize(b) << endl;
+  auto json = JsonSerializer().serialize(b);
+  cout << json << endl;
+  // 反序列化
+  auto b2 = JsonDeserializer().deserialize<B>(json);
+  cout << b2.toString() << endl;
+  // 直接写入输出流，不在内存中拼出完整结果
+  OstreamSink sink(cout);
+  SinkSerializer<JsonOutput>(sink).serialize(b2);
+  cout << endl;
+  // 只接受JSON语法的数字，from_chars本身还接受前导零、inf和nan
+  for (auto bad : {R"({"i":007})", R"({"d":inf})", R"({"d":-infinity})", R"({"d":nan})",
+                   R"({"d":1.})", R"({"d":.5})", R"({"i":+1})", R"({"d":1e})", R"({"i":1.5})"}) {
+    try {
+      JsonDeserializer().deserialize<Numbers>(bad);
+      cout << "accepted " << bad << endl;
+      return 1;
+    } catch (const std::runtime_error &) {}
+  }
+  auto numbers = JsonDeserializer().deserialize<Numbers>(R"({"i":-0,"d":-1.5E+2})");
+  if (numbers.i != 0 || numbers.d != -150) return 1;
+  // 不递归的输出与JsonSerializer一致，复用时arena中的迭代器已经释放
+  Queues queues;
+  queues.deque = {{1, 2}, {}, {3}};
+  queues.list = {numbers, numbers};
+  IterativeJsonSerializer iterative;
+  for (int i = 0; i < 2; ++i) {
+    if (iterative.serialize(queues) != JsonSerializer().serialize(queues)) return 1;
+    queues.deque.emplace_back(100, i);
+  }
+  // 空的数值数组不拷贝数据
+  auto empty = BinaryDeserializer().deserialize<std::vector<double>>(BinarySerializer().serialize(std::vector<double>()));
+  if (!empty.empty()) return 1;
 }
\ No newline at end of file
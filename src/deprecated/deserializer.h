@@ -1,7 +1,15 @@
 #ifndef LIBYURI__DESERIALIZER_H_
 #define LIBYURI__DESERIALIZER_H_
 #include <iostream>
+#include <cstdint>
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <memory_resource>
 #include "reflect.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #define PARSE_ERROR(what) YURI_ERROR << "parse " << what << " failed. str = " << (std::string(str).insert(off,"\e[31m").insert(str.size(),"\e[0m")) << ", off = " << off  << "\n"
 #define PARSE_SPACE() if (!parse_space(str, off)){PARSE_ERROR("space");return false;}
@@ -12,14 +20,14 @@ namespace reflect {
   * 反序列化
   */
     // parse函数类型，传入要解析的字符串、偏移量、要赋值的地址
-    using parse_func = bool (*)(const std::string &, size_t &off, void *);
+    using parse_func = bool (*)(std::string_view, size_t &off, void *);
 
     // 对于null，调用parse_unknown_field会解析成该类型
     struct null {};
     // 前向声明
     template<typename T>
-    inline static bool deserialize(const std::string &, size_t &off, void *ptr);
-    inline bool parse_space(const std::string &str, size_t &off);
+    inline static bool deserialize(std::string_view, size_t &off, void *ptr);
+    inline bool parse_space(std::string_view str, size_t &off);
 
     inline bool isspace(char c) {
       switch (c) {
@@ -33,17 +41,306 @@ namespace reflect {
       }
     }
 
+    // 对64字节的块按字符分类，每个掩码的第i位对应块内第i个字节
+    struct BlockMasks {
+      uint64_t whitespace;
+      // 结构字符：{ } [ ] , :
+      uint64_t structural;
+      uint64_t quote;
+      uint64_t backslash;
+    };
+
+    inline BlockMasks classify_block(const char *block) {
+      BlockMasks masks{0, 0, 0, 0};
+#if defined(__SSE2__)
+      const __m128i space = _mm_set1_epi8(' ');
+      const __m128i tab = _mm_set1_epi8('\t');
+      const __m128i four = _mm_set1_epi8(4);
+      const __m128i quote = _mm_set1_epi8('"');
+      const __m128i backslash = _mm_set1_epi8('\\');
+      for (int i = 0; i < 4; i++) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i * 16));
+        // \t \n \v \f \r是连续的0x09~0x0D
+        __m128i control = _mm_sub_epi8(chunk, tab);
+        __m128i ws = _mm_or_si128(_mm_cmpeq_epi8(chunk, space),
+                                  _mm_cmpeq_epi8(_mm_min_epu8(control, four), control));
+        __m128i st = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('{')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('}'))),
+            _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('[')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8(']'))),
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(',')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8(':')))));
+        auto shift = i * 16;
+        masks.whitespace |= uint64_t(uint16_t(_mm_movemask_epi8(ws))) << shift;
+        masks.structural |= uint64_t(uint16_t(_mm_movemask_epi8(st))) << shift;
+        masks.quote |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote)))) << shift;
+        masks.backslash |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, backslash)))) << shift;
+      }
+#else
+      for (int i = 0; i < 64; i++) {
+        auto bit = uint64_t(1) << i;
+        switch (block[i]) {
+          case '{':
+          case '}':
+          case '[':
+          case ']':
+          case ',':
+          case ':':masks.structural |= bit;
+            break;
+          case '"':masks.quote |= bit;
+            break;
+          case '\\':masks.backslash |= bit;
+            break;
+          default:
+            if (isspace(block[i])) masks.whitespace |= bit;
+        }
+      }
+#endif
+      return masks;
+    }
+
+    // 分类str从off开始的64字节，不足64字节的部分用'\0'填充（'\0'不属于任何一类）
+    inline BlockMasks classify_at(std::string_view str, size_t off) {
+      if (str.size() - off >= 64) {
+        return classify_block(str.data() + off);
+      }
+      char block[64] = {};
+      std::memcpy(block, str.data() + off, str.size() - off);
+      return classify_block(block);
+    }
+
+    // 最近一次分类的块，起点是相对str开头的64字节对齐位置
+    // 同一块内的多次查找（跳过缩进、扫描短字符串）共用一次分类，只做移位和ctz
+    struct BlockCache {
+      const char *data = nullptr;
+      size_t size = 0;
+      size_t start = 0;
+      BlockMasks masks{};
+      // 嵌套的block_scope个数，为0时不使用缓存
+      size_t depth = 0;
+    };
+
+    inline BlockCache &block_cache() {
+      thread_local BlockCache cache;
+      return cache;
+    }
+
+    // 缓存只在一次解析期间有效，最外层的block_scope进入时清空
+    // 两次解析之间同一块内存可能写入了新内容，只凭地址和长度无法区分
+    class block_scope {
+     public:
+      block_scope() {
+        auto &cache = block_cache();
+        if (cache.depth++ == 0) cache.data = nullptr;
+      }
+      block_scope(const block_scope &) = delete;
+      block_scope &operator=(const block_scope &) = delete;
+      ~block_scope() { block_cache().depth--; }
+    };
+
+    // 在一次解析中途解析另一段输入，两段输入可能先后使用同一块内存，离开时恢复外层的缓存
+    class isolated_block_scope {
+      BlockCache saved;
+     public:
+      isolated_block_scope() : saved(block_cache()) {
+        auto &cache = block_cache();
+        cache.data = nullptr;
+        cache.depth++;
+      }
+      isolated_block_scope(const isolated_block_scope &) = delete;
+      isolated_block_scope &operator=(const isolated_block_scope &) = delete;
+      ~isolated_block_scope() { block_cache() = saved; }
+    };
+
+    inline BlockMasks classify_cached(std::string_view str, size_t start) {
+      auto &cache = block_cache();
+      if (cache.depth == 0) return classify_at(str, start);
+      if (cache.data != str.data() || cache.size != str.size() || cache.start != start) {
+        cache.masks = classify_at(str, start);
+        cache.data = str.data();
+        cache.size = str.size();
+        cache.start = start;
+      }
+      return cache.masks;
+    }
+
+    // 从off开始找到第一个在mask_of(masks)中的字节，找不到时返回str.size()
+    template<typename MaskOf>
+    inline size_t find_in_blocks(std::string_view str, size_t off, MaskOf mask_of) {
+      if (off >= str.size()) return str.size();
+      size_t start = off & ~size_t(63);
+      // 第一块去掉off之前的字节
+      if (auto mask = mask_of(classify_cached(str, start)) >> (off - start); mask != 0) {
+        return std::min(off + __builtin_ctzll(mask), str.size());
+      }
+      for (start += 64; start < str.size(); start += 64) {
+        if (auto mask = mask_of(classify_cached(str, start)); mask != 0) {
+          return std::min(start + __builtin_ctzll(mask), str.size());
+        }
+      }
+      return str.size();
+    }
+
+    // 跳过未知值时用到的分类，open是{ [，close是} ]
+    struct BracketMasks {
+      uint64_t open;
+      uint64_t close;
+      uint64_t quote;
+      uint64_t backslash;
+    };
+
+    // 分类str从off开始的64字节，超出str的部分不属于任何一类
+    inline BracketMasks classify_brackets(std::string_view str, size_t off) {
+      const char *block = str.data() + off;
+      char padded[64] = {};
+      if (str.size() - off < 64) {
+        std::memcpy(padded, block, str.size() - off);
+        block = padded;
+      }
+      BracketMasks masks{0, 0, 0, 0};
+#if defined(__SSE2__)
+      for (int i = 0; i < 4; i++) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i * 16));
+        __m128i open = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('{')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('[')));
+        __m128i close = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('}')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8(']')));
+        auto shift = i * 16;
+        masks.open |= uint64_t(uint16_t(_mm_movemask_epi8(open))) << shift;
+        masks.close |= uint64_t(uint16_t(_mm_movemask_epi8(close))) << shift;
+        masks.quote |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"'))))) << shift;
+        masks.backslash |=
+            uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'))))) << shift;
+      }
+#else
+      for (int i = 0; i < 64; i++) {
+        auto bit = uint64_t(1) << i;
+        switch (block[i]) {
+          case '{':
+          case '[':masks.open |= bit;
+            break;
+          case '}':
+          case ']':masks.close |= bit;
+            break;
+          case '"':masks.quote |= bit;
+            break;
+          case '\\':masks.backslash |= bit;
+            break;
+          default:break;
+        }
+      }
+#endif
+      return masks;
+    }
+
+    // 跳过off处的对象或数组，每次处理64字节：先算出哪些字节在字符串内，再统计块内的括号
+    // 块内的右括号不足以回到深度0时整块跳过，否则逐个找到深度归零的位置
+    inline bool skip_container(std::string_view str, size_t &off) {
+      size_t depth = 0;
+      // 上一块结尾是否在字符串内，上一块最后一个字节是否是未被转义的反斜杠
+      uint64_t in_string = 0;
+      uint64_t escape_next = 0;
+      for (size_t pos = off; pos < str.size(); pos += 64) {
+        auto masks = classify_brackets(str, pos);
+        // 被转义的字符，反斜杠通常很少，逐个处理
+        uint64_t escaped = escape_next;
+        escape_next = 0;
+        for (uint64_t bs = masks.backslash & ~escaped; bs != 0; bs &= bs - 1) {
+          auto bit = bs & -bs;
+          if (bit == uint64_t(1) << 63) {
+            escape_next = 1;
+          } else {
+            escaped |= bit << 1;
+            // 被转义的反斜杠不再转义下一个字符
+            bs &= ~(bit << 1);
+          }
+        }
+        // 前缀异或：字符串内的字节（包括开头的引号，不包括结尾的引号）为1
+        uint64_t quotes = masks.quote & ~escaped;
+        uint64_t inside = quotes;
+        for (int shift = 1; shift < 64; shift <<= 1) inside ^= inside << shift;
+        inside ^= in_string;
+        in_string = uint64_t(int64_t(inside) >> 63);
+        uint64_t open = masks.open & ~inside;
+        uint64_t close = masks.close & ~inside;
+        if (size_t(__builtin_popcountll(close)) < depth) {
+          depth += __builtin_popcountll(open) - __builtin_popcountll(close);
+          continue;
+        }
+        for (uint64_t brackets = open | close; brackets != 0; brackets &= brackets - 1) {
+          auto bit = brackets & -brackets;
+          if (open & bit) {
+            depth++;
+          } else if (--depth == 0) {
+            auto end = pos + __builtin_ctzll(bit) + 1;
+            if (end > str.size()) return false;
+            off = end;
+            return true;
+          }
+        }
+      }
+      return false;
+    }
+
+    // 当前线程反序列化时使用的memory_resource，nullptr时使用默认的new/delete
+    inline std::pmr::memory_resource *&current_resource() {
+      thread_local std::pmr::memory_resource *resource = nullptr;
+      return resource;
+    }
+
+    // 在作用域内，当前线程解析出的智能指针指向的对象、pmr字符串和容器都从resource分配
+    // 解析出的对象需要在resource之前销毁
+    class ResourceScope {
+      std::pmr::memory_resource *saved;
+     public:
+      explicit ResourceScope(std::pmr::memory_resource *resource) : saved(current_resource()) {
+        current_resource() = resource;
+      }
+      ResourceScope(const ResourceScope &) = delete;
+      ResourceScope &operator=(const ResourceScope &) = delete;
+      ~ResourceScope() { current_resource() = saved; }
+    };
+
+    template<typename D>
+    using has_allocator_type_t = typename D::allocator_type;
+
+    // 使用polymorphic_allocator的字符串、容器在解析前换成当前的memory_resource
+    template<typename T>
+    inline void adopt_resource(T &t) {
+      if constexpr (std::experimental::is_detected_v<has_allocator_type_t, T>) {
+        using allocator_type = typename T::allocator_type;
+        if constexpr (std::is_same_v<allocator_type, std::pmr::polymorphic_allocator<typename allocator_type::value_type>>) {
+          auto resource = current_resource();
+          if (resource != nullptr && t.get_allocator().resource() != resource) {
+            // 容器的allocator不随赋值传播，只能重新构造
+            t.~T();
+            new(&t) T(allocator_type(resource));
+          }
+        }
+      }
+    }
+
+    // 智能指针指向的对象，有memory_resource时用allocate_shared，对象和控制块一起从resource分配
+    template<typename T>
+    inline std::shared_ptr<T> make_shared_object() {
+      if (auto resource = current_resource(); resource != nullptr) {
+        return std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(resource));
+      }
+      return std::make_shared<T>();
+    }
+
     // 反序列化类
     class Deserializer {
      public:
       // 管理type_id到parse_func的映射
       // 初始化时注册用于解析unknown_field的函数
-      inline static std::unordered_map<TypeID, parse_func> handler;
+      static handler_table<parse_func> &handler() {
+        static handler_table<parse_func> table;
+        return table;
+      }
      public:
-      inline static bool parse(reflect::TypeID id, const std::string &str, size_t &off, void *ptr) {
+      inline static bool parse(reflect::TypeID id, std::string_view str, size_t &off, void *ptr) {
+        block_scope scope;
         PARSE_SPACE();
-        if (auto it = handler.find(id); it != handler.end()) {
-          return it->second(str, off, ptr);
+        if (auto func = handler().find(id); func != nullptr) {
+          return func(str, off, ptr);
         } else {
           YURI_ERROR << "no such handler\n";
           return false;
@@ -51,14 +348,14 @@ namespace reflect {
       }
       // 解析一个未知的字段
       // 如果out是nullptr，则丢弃解析结果
-      static bool parse_unknown_field(const std::string &str, size_t &off, std::any *out) __attribute__((noinline));
+      static bool parse_unknown_field(std::string_view str, size_t &off, std::any *out) __attribute__((noinline));
       // 注册一个T类型的parse_func到Deserializer的handler中
       template<typename T>
-      inline static void register_handler() { handler[type_id<T>] = deserialize<T>; }
+      inline static void register_handler() { handler().insert(type_id<T>, deserialize<T>); }
     };
 
     template<typename T>
-    inline static T reflect_default_deserialize(const std::string &str) {
+    inline static T reflect_default_deserialize(std::string_view str) {
       size_t off = 0;
       T t;
       if (!Deserializer::parse(type_id<T>, str, off, &t)) {
@@ -67,7 +364,19 @@ namespace reflect {
       return t;
     }
 
-    inline static std::any reflect_deserialize_unknown(const std::string &str) {
+    template<typename T>
+    inline static T reflect_default_deserialize(const char *data, size_t size) {
+      return reflect_default_deserialize<T>(std::string_view(data, size));
+    }
+
+    // 解析过程中的分配都来自resource，例如传入std::pmr::monotonic_buffer_resource，整个对象图一次释放
+    template<typename T>
+    inline static T reflect_default_deserialize(std::string_view str, std::pmr::memory_resource *resource) {
+      ResourceScope scope(resource);
+      return reflect_default_deserialize<T>(str);
+    }
+
+    inline static std::any reflect_deserialize_unknown(std::string_view str) {
       size_t off = 0;
       std::any val;
       if (!Deserializer::parse_unknown_field(str, off, &val)) {
@@ -79,21 +388,89 @@ namespace reflect {
     // 具体实现
 
 
-    // 解析空格
-    inline bool parse_space(const std::string &str, size_t &off) {
-      while (isspace(str[off]) && off < str.size())off++;
+    // 解析空格，紧凑的JSON通常没有空白，先检查一个字节；否则按64字节的块跳到下一个非空白字符
+    inline bool parse_space(std::string_view str, size_t &off) {
+      if (off < str.size() && !isspace(str[off])) return true;
+      off = find_in_blocks(str, off, [](const BlockMasks &masks) { return ~masks.whitespace; });
       return off < str.size();
     }
     // 解析一个字符，如果str[off]是该字符，则解析成功，off自增1并返回true，否则返回false
-    inline bool parse_ch(char ch, const std::string &str, size_t &off) {
+    inline bool parse_ch(char ch, std::string_view str, size_t &off) {
       PARSE_SPACE();
       if (str[off] != ch)return false;
       off++;
       return true;
     }
+    // 用std::from_chars解析数字，与locale无关；解析失败或超出T的范围时返回false且不修改t
+    template<typename T>
+    inline bool parse_number(std::string_view str, size_t &off, T &t) {
+      const char *first = str.data() + off;
+      const char *last = str.data() + str.size();
+      if constexpr (std::is_integral_v<T>) {
+        // 快速路径：不超过digits10位的整数不会溢出，直接逐位累加
+        const char *p = first;
+        bool negative = std::is_signed_v<T> && p != last && *p == '-';
+        if (negative) p++;
+        const char *digits = p;
+        const char *limit = p + std::min<size_t>(last - p, std::numeric_limits<T>::digits10);
+        T val = 0;
+        while (p != limit && static_cast<unsigned char>(*p - '0') < 10) {
+          val = static_cast<T>(val * 10 + (*p++ - '0'));
+        }
+        if (p != digits && (p == last || static_cast<unsigned char>(*p - '0') >= 10)) {
+          t = negative ? static_cast<T>(-val) : val;
+          off = p - str.data();
+          return true;
+        }
+      }
+      auto[ptr, ec] = std::from_chars(first, last, t);
+      if (ec != std::errc() || ptr == first) return false;
+      off = ptr - str.data();
+      return true;
+    }
+    // off指向开头的引号，跳到结尾的引号之后，反斜杠转义其后的一个字符
+    inline bool skip_string(std::string_view str, size_t &off) {
+      auto save = off++;
+      while (true) {
+        off = find_in_blocks(str, off, [](const BlockMasks &masks) { return masks.quote | masks.backslash; });
+        if (off >= str.size() || str[off] == '"') break;
+        off += 2;
+      }
+      if (off >= str.size()) {
+        off = save;
+        return false;
+      }
+      off++;
+      return true;
+    }
+    // 跳过一个值，只跟踪字符串和括号深度，不检查其余语法，不分配内存，也不转换数字
+    inline bool skip_value(std::string_view str, size_t &off) {
+      if (!parse_space(str, off)) return false;
+      if (str[off] == '"') return skip_string(str, off);
+      if (str[off] != '{' && str[off] != '[') {
+        // 数字、true、false、null，到下一个结构字符或空白为止
+        auto end = find_in_blocks(str, off, [](const BlockMasks &masks) { return masks.structural | masks.whitespace; });
+        if (end == off || str[off] == '}' || str[off] == ']') return false;
+        off = end;
+        return true;
+      }
+      return skip_container(str, off);
+    }
+    // 按字段名查找reflect类型T的字段，找不到时返回nullptr；索引在第一次调用时构造
+    template<typename T>
+    inline const FieldInfo *find_field(std::string_view name) {
+      static const auto index = [] {
+        std::unordered_map<std::string_view, const FieldInfo *> index;
+        for (auto &field : T::get_field_info_vec()) index.emplace(field.name, &field);
+        return index;
+      }();
+      auto it = index.find(name);
+      return it == index.end() ? nullptr : it->second;
+    }
 // 获取类型T的反序列化函数
     template<typename T>
-    inline static bool deserialize(const std::string &str, size_t &off, void *ptr) {
+    inline static bool deserialize(std::string_view str, size_t &off, void *ptr) {
+      block_scope scope;
       // bool类型
       if constexpr (std::is_same_v<T, bool>) {
         PARSE_SPACE();
@@ -121,37 +498,19 @@ namespace reflect {
         }
         return true;
       }
-        // 整数类型，先转为long long，再强转为T
-      else if constexpr (std::is_integral_v<T>) {
+        // 数字类型，直接按T的宽度解析，超出T的范围时失败
+      else if constexpr (std::is_arithmetic_v<T>) {
         PARSE_SPACE();
-        auto &t = *static_cast<T *>(ptr);
-        char *end;
-        auto val = strtoll(str.c_str() + off, &end, 10);
-        if (errno != 0 || end == str.c_str()) {
-          PARSE_ERROR("integral");
-          return false;
-        }
-        off = end - str.c_str();
-        t = static_cast<T>(val);
-        return true;
-      }
-        // 浮点类型，先转为double，再强转为T
-      else if constexpr(std::is_floating_point_v<T>) {
-        PARSE_SPACE();
-        auto &t = *static_cast<T *>(ptr);
-        char *end;
-        auto val = strtof64(str.c_str() + off, &end);
-        if (errno != 0 || end == str.c_str()) {
-          PARSE_ERROR("floating_point");
+        if (!parse_number(str, off, *static_cast<T *>(ptr))) {
+          PARSE_ERROR((std::is_integral_v<T> ? "integral" : "floating_point"));
           return false;
         }
-        off = end - str.c_str();
-        t = static_cast<T>(val);
         return true;
       }
         // 字符串类型
-      else if constexpr(std::is_same_v<T, std::string>) {
+      else if constexpr(is_char_string_v<T>) {
         auto &t = *static_cast<T *>(ptr);
+        adopt_resource(t);
         PARSE_SPACE();
         if (str.size() - off < 2) {
           PARSE_ERROR("string");
@@ -163,8 +522,12 @@ namespace reflect {
           return false;
         }
         auto save = off;
-        // 字符串内容
-        while ((str[off] != '"' || str[off - 1] == '\\') && off < str.size())off++;
+        // 字符串内容，直接跳到下一个引号或反斜杠，反斜杠转义其后的一个字符
+        while (true) {
+          off = find_in_blocks(str, off, [](const BlockMasks &masks) { return masks.quote | masks.backslash; });
+          if (off >= str.size() || str[off] == '"') break;
+          off += 2;
+        }
         if (off >= str.size()) {
           PARSE_ERROR("string");
           off = save;
@@ -186,6 +549,7 @@ namespace reflect {
         }
         // 循环解析每一个元素
         auto &vec = *static_cast<T *>(ptr);
+        adopt_resource(vec);
         vec.clear();
         // 该数组中没有元素
         if (parse_ch(']', str, off)) {
@@ -277,29 +641,40 @@ namespace reflect {
         if (parse_ch('}', str, off)) {
           return true;
         }
-        T &t = *static_cast<T *>(ptr);
+        auto &fields = T::get_field_info_vec();
+        // 序列化端通常按声明顺序输出字段，先猜key是上一个字段的下一个
+        size_t expected = 0;
         // 循环解析字段
         while (true) {
-          // 解析key
-          std::string key;
-          if (!deserialize<std::string>(str, off, &key)) {
-            PARSE_ERROR(key);
+          // 解析key，与deserialize<std::string>一样不处理转义，直接引用输入
+          PARSE_SPACE();
+          auto key_begin = off + 1;
+          if (str[off] != '"' || !skip_string(str, off)) {
+            PARSE_ERROR("key");
             return false;
           }
+          std::string_view key = str.substr(key_begin, off - 1 - key_begin);
           if (!parse_ch(':', str, off)) {
             PARSE_ERROR(":");
             return false;
           }
-          // 不存在该key时，调用parse_unknown_field以解析未知该value并丢弃
-          if (auto id = t.get_type_id_by_name(key); id == nullptr) {
-            if (!Deserializer::parse_unknown_field(str, off, nullptr)) {
-              PARSE_ERROR("unknown field " + key);
+          const FieldInfo *field = nullptr;
+          if (expected < fields.size() && fields[expected].name.size() == key.size()
+              && std::memcmp(fields[expected].name.data(), key.data(), key.size()) == 0) {
+            field = &fields[expected];
+          } else {
+            field = find_field<T>(key);
+          }
+          // 不存在该key时，直接跳过该value
+          if (field == nullptr) {
+            if (!skip_value(str, off)) {
+              PARSE_ERROR("unknown field " + std::string(key));
               return false;
             }
           } else {
-            // 存在该key时，获取该key对应的type_id、偏移量，然后递归调用parse解析
-            size_t offset = t.get_offset_by_name(key);
-            if (!Deserializer::parse(id, str, off, ((char *) ptr) + offset)) {
+            // 存在该key时，按该字段的type_id、偏移量递归调用parse解析
+            expected = field - fields.data() + 1;
+            if (!Deserializer::parse(field->type_id, str, off, ((char *) ptr) + field->offset)) {
               PARSE_ERROR(key);
               return false;
             }
@@ -326,7 +701,7 @@ namespace reflect {
           off += 4;
           return true;
         }
-        *static_cast<T *>(ptr) = std::make_shared<element_type>();
+        *static_cast<T *>(ptr) = make_shared_object<element_type>();
         if (!deserialize<element_type>(str, off, static_cast<T *>(ptr)->get())) {
           PARSE_ERROR("pointer");
           return false;
@@ -336,7 +711,15 @@ namespace reflect {
         static_assert(std::experimental::is_detected_v<reflect::has_get_field_info_t, T>, "can not parse");
       }
     }
-    bool Deserializer::parse_unknown_field(const std::string &str, size_t &off, std::any *out) {
+    bool Deserializer::parse_unknown_field(std::string_view str, size_t &off, std::any *out) {
+      block_scope scope;
+      if (out == nullptr) {
+        if (!skip_value(str, off)) {
+          PARSE_ERROR("unknown_field");
+          return false;
+        }
+        return true;
+      }
       PARSE_SPACE();
       switch (str[off]) {
         // 数组
@@ -344,6 +727,11 @@ namespace reflect {
           // 左中括号
           parse_ch('[', str, off);
           std::vector<std::any> va;
+          // 空数组
+          if (parse_ch(']', str, off)) {
+            *out = std::any(std::move(va));
+            return true;
+          }
           // 循环解析数组内容
           for (;;) {
             std::any val;
@@ -369,6 +757,11 @@ namespace reflect {
           // 左大括号
           parse_ch('{', str, off);
           Object obj;
+          // 空对象
+          if (parse_ch('}', str, off)) {
+            *out = std::any(std::move(obj));
+            return true;
+          }
           // 循环解析字段
           while (true) {
             std::string key;
@@ -448,7 +841,7 @@ namespace reflect {
   }
   using Deserializer = json::Deserializer;
   template<typename T>
-  T parse(const std::string &str) {
+  T parse(std::string_view str) {
     size_t off = 0;
     T t;
     if (!json::deserialize<T>(str, off, &t)) {
@@ -456,7 +849,11 @@ namespace reflect {
     }
     return t;
   }
-  std::any parse(const std::string &str) {
+  template<typename T>
+  T parse(const char *data, size_t size) {
+    return parse<T>(std::string_view(data, size));
+  }
+  inline std::any parse(std::string_view str) {
     size_t off = 0;
     std::any a;
     if (!Deserializer::parse_unknown_field(str, off, &a)) {
@@ -0,0 +1,330 @@
+#ifndef LIBYURI__DOCUMENT_H_
+#define LIBYURI__DOCUMENT_H_
+#include "deserializer.h"
+
+namespace reflect {
+  namespace json {
+    /*
+     * 不需要反序列化成具体类型时使用的JSON文档
+     * 所有值按前序存放在一个数组中，字符串直接引用输入，释放整个文档只有一次deallocation
+     */
+
+    enum class value_type : uint8_t { invalid, null, boolean, integer, number, string, array, object };
+
+    // 对象的成员在tape中是key、value交替排列
+    struct tape_node {
+      value_type type;
+      // 字符串的长度，数组的元素个数，对象的成员个数
+      uint32_t size;
+      union {
+        // boolean也存放在这里
+        int64_t integer;
+        double number;
+        // 字符串在输入中的起点
+        uint32_t begin;
+        // 数组、对象之后的第一个节点的下标，用于跳过整个子树
+        uint32_t end;
+      };
+    };
+    static_assert(sizeof(tape_node) == 16);
+
+    class Document;
+    class Value;
+
+    struct Member {
+      std::string_view key;
+      Value value() const;
+      const Document *doc;
+      uint32_t index;
+    };
+
+    // 文档中的一个值，只保存文档指针和下标，可以随意复制
+    // 类型不符时as_xxx返回默认值，不存在的下标或key返回invalid
+    class Value {
+      friend class Document;
+      friend struct Member;
+      const Document *doc = nullptr;
+      uint32_t index = 0;
+      Value(const Document *doc, uint32_t index) : doc(doc), index(index) {}
+      const tape_node &node() const;
+      // 跳过当前值，返回下一个兄弟节点的下标
+      uint32_t next() const;
+     public:
+      Value() = default;
+
+      // 遍历数组的元素或对象的成员
+      template<bool Object>
+      class iterator {
+        friend class Value;
+        const Document *doc;
+        uint32_t index;
+        iterator(const Document *doc, uint32_t index) : doc(doc), index(index) {}
+       public:
+        using value_type = std::conditional_t<Object, Member, Value>;
+        value_type operator*() const;
+        iterator &operator++();
+        bool operator==(const iterator &other) const { return index == other.index; }
+        bool operator!=(const iterator &other) const { return index != other.index; }
+      };
+      template<bool Object>
+      struct range {
+        iterator<Object> first, last;
+        iterator<Object> begin() const { return first; }
+        iterator<Object> end() const { return last; }
+      };
+
+      value_type type() const { return doc == nullptr ? value_type::invalid : node().type; }
+      explicit operator bool() const { return type() != value_type::invalid; }
+      bool is_null() const { return type() == value_type::null; }
+      bool is_bool() const { return type() == value_type::boolean; }
+      // integer和number都是数字，整数超出int64范围时解析成number
+      bool is_number() const { return type() == value_type::integer || type() == value_type::number; }
+      bool is_string() const { return type() == value_type::string; }
+      bool is_array() const { return type() == value_type::array; }
+      bool is_object() const { return type() == value_type::object; }
+
+      bool as_bool() const { return is_bool() && node().integer != 0; }
+      int64_t as_int64() const;
+      double as_double() const;
+      // 与deserialize<std::string>一样保留转义序列原文
+      std::string_view as_string() const;
+
+      // 数组的元素个数或对象的成员个数
+      size_t size() const { return is_array() || is_object() ? node().size : 0; }
+      Value operator[](size_t i) const;
+      Value operator[](std::string_view key) const;
+      range<false> elements() const;
+      range<true> members() const;
+    };
+
+    class Document {
+      friend class Value;
+      friend struct Member;
+      std::string_view input;
+      std::vector<tape_node> tape;
+     private:
+      bool error(std::string_view what, size_t off) {
+        YURI_ERROR << "document parse " << what << " failed at offset " << off << "\n";
+        tape.clear();
+        return false;
+      }
+      bool parse_string(size_t &off) {
+        auto begin = ++off;
+        while (true) {
+          off = find_in_blocks(input, off, [](const BlockMasks &masks) { return masks.quote | masks.backslash; });
+          if (off >= input.size() || input[off] == '"') break;
+          off += 2;
+        }
+        if (off >= input.size()) return error("string", begin - 1);
+        auto &node = tape.emplace_back();
+        node.type = value_type::string;
+        node.size = static_cast<uint32_t>(off - begin);
+        node.begin = static_cast<uint32_t>(begin);
+        off++;
+        return true;
+      }
+      bool parse_literal(size_t &off, std::string_view literal, value_type type, int64_t value) {
+        if (input.substr(off, literal.size()) != literal) return error("literal", off);
+        off += literal.size();
+        auto &node = tape.emplace_back();
+        node.type = type;
+        node.integer = value;
+        return true;
+      }
+      // 按JSON的数字语法 -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)? 找到数字的结尾，不符合时返回npos
+      // from_chars还接受inf、nan和前导零，所以要先检查
+      size_t number_end(size_t off, bool &integral) const {
+        auto digit = [&](size_t i) { return i < input.size() && static_cast<unsigned char>(input[i] - '0') < 10; };
+        auto digits = [&](size_t &i) {
+          if (!digit(i)) return false;
+          while (digit(i)) i++;
+          return true;
+        };
+        if (off < input.size() && input[off] == '-') off++;
+        if (!digit(off)) return std::string_view::npos;
+        if (input[off] == '0') {
+          if (digit(++off)) return std::string_view::npos;
+        } else {
+          digits(off);
+        }
+        integral = true;
+        if (off < input.size() && input[off] == '.') {
+          integral = false;
+          if (!digits(++off)) return std::string_view::npos;
+        }
+        if (off < input.size() && (input[off] == 'e' || input[off] == 'E')) {
+          integral = false;
+          if (++off < input.size() && (input[off] == '+' || input[off] == '-')) off++;
+          if (!digits(off)) return std::string_view::npos;
+        }
+        return off;
+      }
+      // 没有小数点和指数的数字先按int64解析，溢出时再按double解析
+      bool parse_numeric(size_t &off) {
+        auto begin = off;
+        bool integral;
+        auto end = number_end(off, integral);
+        if (end == std::string_view::npos) return error("number", begin);
+        // 只让from_chars看到检查过的部分
+        auto number = input.substr(0, end);
+        auto &node = tape.emplace_back();
+        node.type = value_type::integer;
+        if (integral && parse_number(number, off, node.integer)) return true;
+        off = begin;
+        node.type = value_type::number;
+        if (!parse_number(number, off, node.number)) return error("number", begin);
+        return true;
+      }
+      bool parse_value(size_t &off) {
+        if (!parse_space(input, off)) return error("value", off);
+        switch (input[off]) {
+          case '{':
+          case '[': {
+            bool object = input[off++] == '{';
+            char close = object ? '}' : ']';
+            auto index = static_cast<uint32_t>(tape.size());
+            tape.emplace_back().type = object ? value_type::object : value_type::array;
+            uint32_t count = 0;
+            if (!parse_ch(close, input, off)) {
+              while (true) {
+                if (object) {
+                  if (!parse_space(input, off) || input[off] != '"') return error("key", off);
+                  if (!parse_string(off)) return false;
+                  if (!parse_ch(':', input, off)) return error(":", off);
+                }
+                if (!parse_value(off)) return false;
+                count++;
+                if (!parse_ch(',', input, off)) break;
+              }
+              if (!parse_ch(close, input, off)) return error(std::string(1, close), off);
+            }
+            // emplace_back可能使引用失效，最后再按下标回填
+            tape[index].size = count;
+            tape[index].end = static_cast<uint32_t>(tape.size());
+            return true;
+          }
+          case '"':return parse_string(off);
+          case 't':return parse_literal(off, "true", value_type::boolean, 1);
+          case 'f':return parse_literal(off, "false", value_type::boolean, 0);
+          case 'n':return parse_literal(off, "null", value_type::null, 0);
+          default:return parse_numeric(off);
+        }
+      }
+     public:
+      Document() = default;
+      // 文档引用str中的字符串，str需要比文档活得久
+      explicit Document(std::string_view str) { parse(str); }
+
+      // 解析失败时返回false，root()为invalid；重复使用同一个文档时tape的容量会保留
+      bool parse(std::string_view str) {
+        block_scope scope;
+        tape.clear();
+        input = str;
+        if (str.size() > std::numeric_limits<uint32_t>::max()) return error("size", 0);
+        size_t off = 0;
+        if (!parse_value(off)) return false;
+        // 值之后只允许有空白
+        if (parse_space(input, off)) return error("trailing characters", off);
+        return true;
+      }
+
+      Value root() const { return tape.empty() ? Value() : Value(this, 0); }
+      size_t node_count() const { return tape.size(); }
+    };
+
+    inline const tape_node &Value::node() const { return doc->tape[index]; }
+
+    inline uint32_t Value::next() const {
+      auto &n = node();
+      return n.type == value_type::array || n.type == value_type::object ? n.end : index + 1;
+    }
+
+    inline int64_t Value::as_int64() const {
+      switch (type()) {
+        case value_type::integer:return node().integer;
+        case value_type::number: {
+          // 超出int64范围的double直接转换是未定义行为，截断到范围内，NaN返回0
+          auto number = node().number;
+          if (number != number) return 0;
+          if (number >= static_cast<double>(std::numeric_limits<int64_t>::max())) {
+            return std::numeric_limits<int64_t>::max();
+          }
+          if (number < static_cast<double>(std::numeric_limits<int64_t>::min())) {
+            return std::numeric_limits<int64_t>::min();
+          }
+          return static_cast<int64_t>(number);
+        }
+        default:return 0;
+      }
+    }
+
+    inline double Value::as_double() const {
+      switch (type()) {
+        case value_type::integer:return static_cast<double>(node().integer);
+        case value_type::number:return node().number;
+        default:return 0;
+      }
+    }
+
+    inline std::string_view Value::as_string() const {
+      if (!is_string()) return {};
+      return doc->input.substr(node().begin, node().size);
+    }
+
+    inline Value Member::value() const { return Value(doc, index + 1); }
+
+    template<bool Object>
+    inline typename Value::iterator<Object>::value_type Value::iterator<Object>::operator*() const {
+      if constexpr (Object) {
+        return Member{Value(doc, index).as_string(), doc, index};
+      } else {
+        return Value(doc, index);
+      }
+    }
+
+    template<bool Object>
+    inline Value::iterator<Object> &Value::iterator<Object>::operator++() {
+      // 对象的成员先跳过key，再跳过value
+      if constexpr (Object) index++;
+      index = Value(doc, index).next();
+      return *this;
+    }
+
+    inline Value::range<false> Value::elements() const {
+      if (!is_array()) return {{doc, 0}, {doc, 0}};
+      return {{doc, index + 1}, {doc, node().end}};
+    }
+
+    inline Value::range<true> Value::members() const {
+      if (!is_object()) return {{doc, 0}, {doc, 0}};
+      return {{doc, index + 1}, {doc, node().end}};
+    }
+
+    inline Value Value::operator[](size_t i) const {
+      if (i >= size() || !is_array()) return {};
+      auto it = elements().begin();
+      while (i-- != 0) ++it;
+      return *it;
+    }
+
+    // 线性查找，重复的key返回第一个
+    inline Value Value::operator[](std::string_view key) const {
+      for (auto member : members()) {
+        if (member.key == key) return member.value();
+      }
+      return {};
+    }
+
+    // 解析成Document，失败时返回的文档root()为invalid
+    inline Document reflect_deserialize_document(std::string_view str) {
+      return Document(str);
+    }
+
+    inline Document reflect_deserialize_document(const char *data, size_t size) {
+      return Document(std::string_view(data, size));
+    }
+  }
+  using Document = json::Document;
+}
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef LIBYURI__MAPPED_FILE_H_
+#define LIBYURI__MAPPED_FILE_H_
+#include <cerrno>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "deserializer.h"
+
+namespace reflect {
+  /*
+   * 只读映射一个文件，直接在映射的内存上反序列化，不需要先读进std::string
+   */
+  class MappedFile {
+    const char *_data = nullptr;
+    size_t _size = 0;
+   public:
+    // 打开或映射失败时抛出std::system_error
+    explicit MappedFile(const char *path) {
+      int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+      if (fd < 0) throw std::system_error(errno, std::generic_category(), path);
+      struct stat st{};
+      if (::fstat(fd, &st) != 0) {
+        int err = errno;
+        ::close(fd);
+        throw std::system_error(err, std::generic_category(), path);
+      }
+      _size = static_cast<size_t>(st.st_size);
+      // 长度为0的文件不能mmap
+      if (_size != 0) {
+        void *addr = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+          int err = errno;
+          ::close(fd);
+          throw std::system_error(err, std::generic_category(), path);
+        }
+        ::madvise(addr, _size, MADV_SEQUENTIAL);
+        _data = static_cast<const char *>(addr);
+      }
+      ::close(fd);
+    }
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&other) noexcept : _data(other._data), _size(other._size) {
+      other._data = nullptr;
+      other._size = 0;
+    }
+    ~MappedFile() {
+      if (_data != nullptr) ::munmap(const_cast<char *>(_data), _size);
+    }
+    const char *data() const { return _data; }
+    size_t size() const { return _size; }
+    std::string_view view() const { return std::string_view(_data, _size); }
+  };
+
+  namespace json {
+    // 从文件反序列化一个T，文件只在解析期间被映射
+    template<typename T>
+    inline static T reflect_deserialize_file(const char *path) {
+      MappedFile file(path);
+      return reflect_default_deserialize<T>(file.view());
+    }
+  }
+}
+
+#endif
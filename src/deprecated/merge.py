@@ -2,21 +2,21 @@
 import os
 import io
 
-file_list = ["reflect.h", "serializer.h", "deserializer.h"]
+file_list = ["reflect.h", "serializer.h", "deserializer.h", "document.h", "on_demand.h", "push_parser.h", "mapped_file.h"]
 
 output = open("../yuri.h", "w")
 output.write("#ifndef LIBYURI_YURI_H_\n")
 output.write("#define LIBYURI_YURI_H_\n")
 for file in file_list:
   f = open(file,"r")
-  while True:
-    s = f.readline()
-    if len(s) == 0:
-      break
-    if s.startswith("#ifndef LIB") or s.startswith("#define LIB") or s.startswith('#include "reflect.h"') or s.startswith("#endif"):
+  lines = f.readlines()
+  f.close()
+  # only the last #endif closes the include guard
+  guard_end = max(i for i, s in enumerate(lines) if s.startswith("#endif"))
+  for i, s in enumerate(lines):
+    if s.startswith("#ifndef LIB") or s.startswith("#define LIB") or s.startswith('#include "reflect.h"') or s.startswith('#include "deserializer.h"') or i == guard_end:
       continue
     output.write(s)
-  f.close()
 output.write("#endif\n")
 output.close()
 
@@ -0,0 +1,178 @@
+#ifndef LIBYURI__ON_DEMAND_H_
+#define LIBYURI__ON_DEMAND_H_
+#include "deserializer.h"
+
+namespace reflect {
+  namespace json {
+    /*
+     * 按路径从JSON中取出少数几个值，不构造整个文档
+     * 路径用'/'分隔，对象用key，数组用下标，例如"root/left/data"、"items/0/id"
+     * 与路径无关的子树用skip_value跳过，只检查括号配对
+     */
+
+    class path_walker {
+      std::string_view str;
+      const std::string_view *paths;
+      // 每条路径已经匹配的长度
+      size_t *matched;
+      std::string_view *values;
+      uint64_t found = 0;
+      size_t remaining;
+     private:
+      bool error(std::string_view what, size_t off) {
+        YURI_ERROR << "path walk " << what << " failed at offset " << off << "\n";
+        return false;
+      }
+      // 路径i还没匹配的下一段
+      std::string_view segment(size_t i) const {
+        auto rest = paths[i].substr(matched[i]);
+        return rest.substr(0, rest.find('/'));
+      }
+      bool is_target(size_t i) const { return matched[i] >= paths[i].size(); }
+      template<typename F>
+      static void for_each_bit(uint64_t mask, F &&f) {
+        while (mask != 0) {
+          f(static_cast<size_t>(__builtin_ctzll(mask)));
+          mask &= mask - 1;
+        }
+      }
+      // 下一段匹配的路径进入子节点，返回false表示语法错误
+      bool walk_child(size_t &off, uint64_t child) {
+        if (child == 0) {
+          if (!skip_value(str, off)) return error("value", off);
+          return true;
+        }
+        size_t saved[64];
+        for_each_bit(child, [&](size_t i) {
+          saved[i] = matched[i];
+          matched[i] += segment(i).size() + 1;
+        });
+        bool ok = walk_value(off, child);
+        for_each_bit(child, [&](size_t i) { matched[i] = saved[i]; });
+        return ok;
+      }
+      bool walk_object(size_t &off, uint64_t mask) {
+        off++;
+        if (parse_space(str, off) && str[off] == '}') {
+          off++;
+          return true;
+        }
+        while (true) {
+          if (!parse_space(str, off) || str[off] != '"') return error("key", off);
+          auto begin = off + 1;
+          if (!skip_string(str, off)) return error("key", off);
+          auto key = str.substr(begin, off - 1 - begin);
+          if (!parse_space(str, off) || str[off] != ':') return error(":", off);
+          off++;
+          uint64_t child = 0;
+          for_each_bit(mask & ~found, [&](size_t i) {
+            if (segment(i) == key) child |= uint64_t(1) << i;
+          });
+          if (!walk_child(off, child)) return false;
+          if (remaining == 0) return true;
+          if (!parse_space(str, off)) return error("}", off);
+          if (str[off] == ',') {
+            off++;
+          } else if (str[off] == '}') {
+            off++;
+            return true;
+          } else {
+            return error("}", off);
+          }
+        }
+      }
+      bool walk_array(size_t &off, uint64_t mask) {
+        off++;
+        if (parse_space(str, off) && str[off] == ']') {
+          off++;
+          return true;
+        }
+        for (size_t index = 0;; index++) {
+          uint64_t child = 0;
+          for_each_bit(mask & ~found, [&](size_t i) {
+            auto seg = segment(i);
+            size_t n;
+            auto[ptr, ec] = std::from_chars(seg.data(), seg.data() + seg.size(), n);
+            if (ec == std::errc() && ptr == seg.data() + seg.size() && n == index) child |= uint64_t(1) << i;
+          });
+          if (!walk_child(off, child)) return false;
+          if (remaining == 0) return true;
+          if (!parse_space(str, off)) return error("]", off);
+          if (str[off] == ',') {
+            off++;
+          } else if (str[off] == ']') {
+            off++;
+            return true;
+          } else {
+            return error("]", off);
+          }
+        }
+      }
+      // mask中的路径都匹配到了当前值，已经匹配完的路径取当前值的原文
+      bool walk_value(size_t &off, uint64_t mask) {
+        if (!parse_space(str, off)) return error("value", off);
+        uint64_t targets = 0;
+        for_each_bit(mask, [&](size_t i) {
+          if (is_target(i)) targets |= uint64_t(1) << i;
+        });
+        auto begin = off;
+        uint64_t descend = mask & ~targets;
+        if (descend != 0 && str[off] == '{') {
+          if (!walk_object(off, descend)) return false;
+        } else if (descend != 0 && str[off] == '[') {
+          if (!walk_array(off, descend)) return false;
+        } else if (!skip_value(str, off)) {
+          return error("value", off);
+        }
+        // 子节点中的路径都找到后提前返回时，off没有到达当前值的结尾，但此时targets一定为空
+        for_each_bit(targets, [&](size_t i) {
+          values[i] = str.substr(begin, off - begin);
+          remaining--;
+        });
+        found |= targets;
+        return true;
+      }
+     public:
+      path_walker(std::string_view str, const std::string_view *paths, size_t *matched,
+                  std::string_view *values, size_t count)
+          : str(str), paths(paths), matched(matched), values(values), remaining(count) {}
+      bool walk() {
+        size_t off = 0;
+        uint64_t mask = remaining == 64 ? ~uint64_t(0) : (uint64_t(1) << remaining) - 1;
+        return walk_value(off, mask);
+      }
+    };
+
+    // 一次扫描取出多条路径对应的值在str中的原文，找不到的路径为空；最多64条路径
+    // 经过的部分有语法错误时返回false
+    inline bool find_paths(std::string_view str, const std::string_view *paths, size_t count,
+                           std::string_view *values) {
+      if (count > 64) {
+        YURI_ERROR << "too many paths\n";
+        return false;
+      }
+      block_scope scope;
+      size_t matched[64] = {};
+      for (size_t i = 0; i < count; i++) values[i] = {};
+      if (count == 0) return true;
+      return path_walker(str, paths, matched, values, count).walk();
+    }
+
+    // 取出一条路径对应的值的原文，找不到时返回空
+    inline std::string_view find_path(std::string_view str, std::string_view path) {
+      std::string_view value;
+      find_paths(str, &path, 1, &value);
+      return value;
+    }
+
+    // 取出一条路径对应的值并反序列化成T，找不到或解析失败时返回false
+    template<typename T>
+    inline bool extract(std::string_view str, std::string_view path, T &t) {
+      auto value = find_path(str, path);
+      size_t off = 0;
+      return !value.empty() && deserialize<T>(value, off, &t);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,483 @@
+#ifndef LIBYURI__PUSH_PARSER_H_
+#define LIBYURI__PUSH_PARSER_H_
+#include "deserializer.h"
+
+namespace reflect {
+  namespace json {
+    /*
+     * 推送式解析，输入可以分成任意多段依次传入，每段解析完即可丢弃
+     */
+
+    enum class push_token { string, number, literal };
+
+    struct push_type;
+    // 下一个值的类型和写入地址
+    struct push_slot {
+      const push_type *type;
+      void *target;
+      // 延迟解析的字段的type_id
+      TypeID id = nullptr;
+    };
+    // 正在解析的对象或数组
+    struct push_frame {
+      push_slot slot;
+      // 数组元素的临时对象
+      void *scratch;
+      bool object;
+    };
+
+    // 每种类型一张函数表，不支持的操作为nullptr
+    struct push_type {
+      // 字符串、数字、true/false/null
+      bool (*scalar)(void *target, push_token kind, std::string_view text) = nullptr;
+      // 对象或数组开始，open是'{'或'['
+      bool (*begin)(push_frame &frame, char open) = nullptr;
+      // 对象中的key，确定下一个值的类型和地址
+      bool (*key)(push_frame &frame, std::string_view key, push_slot &child) = nullptr;
+      // 数组的下一个元素
+      void (*element)(push_frame &frame, push_slot &child) = nullptr;
+      // 数组元素解析完成
+      void (*element_done)(push_frame &frame) = nullptr;
+      // 容器结束或解析中止时释放frame持有的资源
+      void (*end)(push_frame &frame) = nullptr;
+      // 智能指针：null时置空并返回nullptr，否则创建对象并返回其地址
+      void *(*deref)(void *target, bool null) = nullptr;
+      const push_type *pointee = nullptr;
+    };
+
+    template<typename T>
+    inline const push_type *push_type_of();
+
+    // 管理type_id到push_type的映射，用于查找reflect类型中字段的类型
+    // 每种类型在push_type_of第一次用到时登记，不需要流式解析的类型不占用这张表
+    inline handler_table<const push_type *> &push_handler() {
+      static handler_table<const push_type *> handler;
+      return handler;
+    }
+
+    // 未知字段的值，只检查语法，不保存
+    inline const push_type *push_skip_type() {
+      static const push_type type = [] {
+        push_type t;
+        t.scalar = [](void *, push_token, std::string_view) { return true; };
+        t.begin = [](push_frame &, char) { return true; };
+        t.key = [](push_frame &, std::string_view, push_slot &child) {
+          child = {push_skip_type(), nullptr};
+          return true;
+        };
+        t.element = [](push_frame &, push_slot &child) { child = {push_skip_type(), nullptr}; };
+        return t;
+      }();
+      return &type;
+    }
+
+    // push_handler中找不到的字段类型，先缓存该值的原文，值结束后交给Deserializer整体解析
+    inline const push_type *push_deferred_type() {
+      static const push_type type;
+      return &type;
+    }
+
+    // 数组元素的临时对象类型；map的value_type是pair<const K,V>，先解析到pair<K,V>中，插入时再移入
+    template<typename V>
+    struct push_element {
+      using type = V;
+    };
+    template<typename K, typename V>
+    struct push_element<std::pair<const K, V>> {
+      using type = std::pair<K, V>;
+    };
+
+    template<typename D>
+    using has_mapped_type_t = typename D::mapped_type;
+
+    template<typename T>
+    inline push_type make_push_type() {
+      push_type t;
+      // bool类型
+      if constexpr (std::is_same_v<T, bool>) {
+        t.scalar = [](void *target, push_token kind, std::string_view text) {
+          if (kind != push_token::literal || (text != "true" && text != "false")) return false;
+          *static_cast<T *>(target) = text == "true";
+          return true;
+        };
+      }
+        // 数字类型
+      else if constexpr (std::is_arithmetic_v<T>) {
+        t.scalar = [](void *target, push_token kind, std::string_view text) {
+          size_t off = 0;
+          return kind == push_token::number && parse_number(text, off, *static_cast<T *>(target))
+              && off == text.size();
+        };
+      }
+        // 字符串类型，与deserialize<std::string>一样保留转义序列原文
+      else if constexpr (is_char_string_v<T>) {
+        t.scalar = [](void *target, push_token kind, std::string_view text) {
+          if (kind != push_token::string) return false;
+          adopt_resource(*static_cast<T *>(target));
+          static_cast<T *>(target)->assign(text);
+          return true;
+        };
+      }
+        // 可迭代类型，元素先解析到临时对象再插入
+      else if constexpr (std::experimental::is_detected_v<reflect::has_begin_t, T>
+          && std::experimental::is_detected_v<reflect::has_end_t, T>) {
+        using value_type = typename push_element<typename T::value_type>::type;
+        t.begin = [](push_frame &frame, char open) {
+          if (open != '[') return false;
+          adopt_resource(*static_cast<T *>(frame.slot.target));
+          static_cast<T *>(frame.slot.target)->clear();
+          frame.scratch = new value_type();
+          return true;
+        };
+        t.element = [](push_frame &frame, push_slot &child) {
+          child = {push_type_of<value_type>(), frame.scratch};
+        };
+        t.element_done = [](push_frame &frame) {
+          auto &vec = *static_cast<T *>(frame.slot.target);
+          auto &value = *static_cast<value_type *>(frame.scratch);
+          if constexpr (std::experimental::is_detected_v<has_mapped_type_t, T>) {
+            vec.emplace_hint(vec.end(), std::move(value.first), std::move(value.second));
+          } else {
+            vec.insert(vec.end(), std::move(value));
+          }
+          value = value_type();
+        };
+        t.end = [](push_frame &frame) {
+          delete static_cast<value_type *>(frame.scratch);
+          frame.scratch = nullptr;
+        };
+      }
+        // pair类型，格式与deserialize相同：{"first":...,"second":...}
+      else if constexpr (std::experimental::is_detected_v<reflect::has_first_t, T>
+          && std::experimental::is_detected_v<reflect::has_second_t, T>) {
+        using first_type = typename T::first_type;
+        using second_type = typename T::second_type;
+        static_assert(!std::is_const_v<first_type>, "key of a map element is parsed through push_element");
+        t.begin = [](push_frame &, char open) { return open == '{'; };
+        t.key = [](push_frame &frame, std::string_view key, push_slot &child) {
+          auto &p = *static_cast<T *>(frame.slot.target);
+          if (key == "first") {
+            child = {push_type_of<first_type>(), &p.first};
+          } else if (key == "second") {
+            child = {push_type_of<second_type>(), &p.second};
+          } else {
+            return false;
+          }
+          return true;
+        };
+      }
+        // reflect类型，字段的类型由type_id在push_handler中查找，未知字段跳过
+      else if constexpr (std::experimental::is_detected_v<reflect::has_get_field_info_t, T>) {
+        t.begin = [](push_frame &, char open) { return open == '{'; };
+        t.key = [](push_frame &frame, std::string_view key, push_slot &child) {
+          if (auto id = T::get_type_id_by_name(key); id == nullptr) {
+            child = {push_skip_type(), nullptr};
+          } else if (auto type = push_handler().find(id); type != nullptr) {
+            child = {type, static_cast<char *>(frame.slot.target) + T::get_offset_by_name(key)};
+          } else {
+            child = {push_deferred_type(), static_cast<char *>(frame.slot.target) + T::get_offset_by_name(key), id};
+          }
+          return true;
+        };
+      }
+        // 智能指针类型
+      else if constexpr(is_shared_ptr_v<T>) {
+        using element_type = typename T::element_type;
+        t.deref = [](void *target, bool null) -> void * {
+          auto &p = *static_cast<T *>(target);
+          if (null) {
+            p = nullptr;
+            return nullptr;
+          }
+          p = make_shared_object<element_type>();
+          return p.get();
+        };
+        t.pointee = push_type_of<element_type>();
+      } else {
+        static_assert(std::experimental::is_detected_v<reflect::has_get_field_info_t, T>, "can not parse");
+      }
+      return t;
+    }
+
+    template<typename T>
+    inline const push_type *push_type_of() {
+      static const push_type type = make_push_type<T>();
+      static const bool registered = (push_handler().insert(type_id<T>, &type), true);
+      (void) registered;
+      return &type;
+    }
+
+    class PushParser {
+      enum class expect { value, value_or_end, key, key_or_end, colon, comma_or_end, done };
+      enum class lex { none, string, scalar };
+     public:
+      // 提前登记T类型的push_type；reflect类型中没有登记过的字段类型会先缓存整个值再解析
+      template<typename T>
+      inline static void register_handler() { push_type_of<T>(); }
+     private:
+      std::vector<push_frame> frames;
+      push_slot pending{};
+      expect state = expect::value;
+      lex token = lex::none;
+      // 跨越了段边界的token
+      std::string partial;
+      // 字符串中上一段以反斜杠结尾
+      bool escaped = false;
+      bool failed = false;
+      // 已经处理过的字节数，用于报错
+      size_t consumed = 0;
+      // 当前这一段输入
+      std::string_view input;
+      // 正在缓存原文的延迟解析字段，depth是该字段所在对象的frames层数
+      struct deferred_value {
+        TypeID id = nullptr;
+        void *target = nullptr;
+        size_t depth = 0;
+        // 之前各段中的原文
+        std::string text;
+        // 本段中原文的起点
+        size_t begin = 0;
+        bool active = false;
+      } deferred;
+     private:
+      bool error(std::string_view what, size_t pos) {
+        YURI_ERROR << "push parse " << what << " failed at offset " << consumed + pos << "\n";
+        failed = true;
+        return false;
+      }
+      static bool is_scalar_char(char c) {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+            || c == '-' || c == '+' || c == '.';
+      }
+      void release() {
+        for (auto &frame : frames) {
+          if (frame.slot.type->end != nullptr) frame.slot.type->end(frame);
+        }
+        frames.clear();
+      }
+      // 延迟解析的字段值到end为止，end之前可能多出一个分隔符，不影响解析
+      bool finish_deferred(size_t end) {
+        deferred.active = false;
+        end = std::min(end, input.size());
+        deferred.text.append(input.data() + deferred.begin, end - deferred.begin);
+        // deferred.text在各个字段之间复用，不能沿用feed中的分类缓存
+        isolated_block_scope scope;
+        size_t off = 0;
+        if (!Deserializer::parse(deferred.id, deferred.text, off, deferred.target)) return error("value", end);
+        return true;
+      }
+      // 一个值解析完成，end是该值在本段输入中的结尾之后的位置
+      bool value_done(size_t end) {
+        if (deferred.active && frames.size() == deferred.depth && !finish_deferred(end)) return false;
+        if (frames.empty()) {
+          state = expect::done;
+          return true;
+        }
+        auto &top = frames.back();
+        if (!top.object && top.slot.type->element_done != nullptr) top.slot.type->element_done(top);
+        state = expect::comma_or_end;
+        return true;
+      }
+      // 取出下一个值的位置，数组中的第一个元素在这里才确定
+      push_slot take_pending() {
+        if (state == expect::value_or_end) {
+          auto &top = frames.back();
+          top.slot.type->element(top, pending);
+        }
+        return pending;
+      }
+      // 解引用智能指针，返回false表示值已经是null
+      static bool resolve(push_slot &slot, bool null) {
+        while (slot.type->deref != nullptr) {
+          slot.target = slot.type->deref(slot.target, null);
+          if (null) return false;
+          slot.type = slot.type->pointee;
+        }
+        return true;
+      }
+      bool on_scalar(push_token kind, std::string_view text, size_t pos) {
+        if (state == expect::key || state == expect::key_or_end) {
+          if (kind != push_token::string) return error("key", pos);
+          auto &top = frames.back();
+          if (!top.slot.type->key(top, text, pending)) return error("key " + std::string(text), pos);
+          state = expect::colon;
+          return true;
+        }
+        if (state != expect::value && state != expect::value_or_end) return error("value", pos);
+        auto slot = take_pending();
+        if (resolve(slot, kind == push_token::literal && text == "null")) {
+          if (slot.type->scalar == nullptr || !slot.type->scalar(slot.target, kind, text)) {
+            return error("value " + std::string(text), pos);
+          }
+        }
+        // 字符串的pos是结尾的引号，数字和字面量的pos是其后的分隔符
+        return value_done(pos + 1);
+      }
+      bool on_structural(char c, size_t pos) {
+        switch (c) {
+          case '{':
+          case '[': {
+            if (state != expect::value && state != expect::value_or_end) return error(std::string(1, c), pos);
+            auto slot = take_pending();
+            resolve(slot, false);
+            frames.push_back(push_frame{slot, nullptr, c == '{'});
+            if (slot.type->begin == nullptr || !slot.type->begin(frames.back(), c)) {
+              return error(std::string(1, c), pos);
+            }
+            state = c == '{' ? expect::key_or_end : expect::value_or_end;
+            return true;
+          }
+          case '}':
+          case ']': {
+            bool object = c == '}';
+            if (frames.empty() || frames.back().object != object
+                || (state != expect::comma_or_end && state != (object ? expect::key_or_end : expect::value_or_end))) {
+              return error(std::string(1, c), pos);
+            }
+            auto &top = frames.back();
+            if (top.slot.type->end != nullptr) top.slot.type->end(top);
+            frames.pop_back();
+            return value_done(pos + 1);
+          }
+          case ':': {
+            if (state != expect::colon) return error(":", pos);
+            if (pending.type == push_deferred_type()) {
+              // 值本身只检查语法，原文从冒号之后开始缓存
+              deferred.id = pending.id;
+              deferred.target = pending.target;
+              deferred.depth = frames.size();
+              deferred.text.clear();
+              deferred.begin = pos + 1;
+              deferred.active = true;
+              pending = {push_skip_type(), nullptr};
+            }
+            state = expect::value;
+            return true;
+          }
+          case ',': {
+            if (state != expect::comma_or_end) return error(",", pos);
+            auto &top = frames.back();
+            if (top.object) {
+              state = expect::key;
+            } else {
+              top.slot.type->element(top, pending);
+              state = expect::value;
+            }
+            return true;
+          }
+          default:return error(std::string(1, c), pos);
+        }
+      }
+      // 一个字符串、数字或字面量结束，text可能指向partial
+      bool finish_token(push_token kind, std::string_view text, size_t pos) {
+        token = lex::none;
+        bool ok = on_scalar(kind, text, pos);
+        partial.clear();
+        return ok;
+      }
+     public:
+      // 没有登记过push_type的类型，整个输入缓存下来，finish时交给Deserializer解析
+      PushParser(TypeID id, void *target) {
+        if (auto type = push_handler().find(id); type != nullptr) {
+          pending = {type, target};
+        } else if (Deserializer::handler().find(id) != nullptr) {
+          pending = {push_skip_type(), nullptr};
+          deferred.id = id;
+          deferred.target = target;
+          deferred.active = true;
+        } else {
+          YURI_ERROR << "no such handler\n";
+          failed = true;
+        }
+      }
+      template<typename T>
+      explicit PushParser(T &target) : pending{push_type_of<T>(), &target} {}
+      PushParser(const PushParser &) = delete;
+      PushParser &operator=(const PushParser &) = delete;
+      ~PushParser() { release(); }
+
+      // 传入下一段输入，出错时返回false，之后的输入都会被忽略
+      bool feed(std::string_view data) {
+        if (failed) return false;
+        // 各段输入可能复用同一块缓冲区，缓存只在一次feed中有效
+        block_scope scope;
+        input = data;
+        size_t i = 0;
+        while (i < data.size()) {
+          if (token == lex::string) {
+            size_t begin = i;
+            if (escaped) {
+              escaped = false;
+              i++;
+            }
+            while (true) {
+              i = find_in_blocks(data, i, [](const BlockMasks &masks) { return masks.quote | masks.backslash; });
+              if (i >= data.size() || data[i] == '"') break;
+              if (i + 1 == data.size()) {
+                escaped = true;
+                i = data.size();
+                break;
+              }
+              i += 2;
+            }
+            if (i >= data.size()) {
+              partial.append(data.data() + begin, data.size() - begin);
+              break;
+            }
+            std::string_view text(data.data() + begin, i - begin);
+            if (!partial.empty()) text = partial.append(text);
+            if (!finish_token(push_token::string, text, i++)) return false;
+          } else if (token == lex::scalar) {
+            size_t begin = i;
+            while (i < data.size() && is_scalar_char(data[i])) i++;
+            std::string_view text(data.data() + begin, i - begin);
+            if (i == data.size()) {
+              partial.append(text);
+              break;
+            }
+            if (!partial.empty()) text = partial.append(text);
+            auto kind = text[0] == '-' || (text[0] >= '0' && text[0] <= '9') ? push_token::number : push_token::literal;
+            if (!finish_token(kind, text, i)) return false;
+          } else {
+            char c = data[i];
+            if (isspace(c)) {
+              i++;
+            } else if (c == '"') {
+              token = lex::string;
+              i++;
+            } else if (is_scalar_char(c)) {
+              token = lex::scalar;
+            } else if (!on_structural(c, i++)) {
+              return false;
+            }
+          }
+        }
+        if (deferred.active) {
+          deferred.text.append(data.data() + deferred.begin, data.size() - deferred.begin);
+          deferred.begin = 0;
+        }
+        consumed += data.size();
+        return true;
+      }
+
+      // 输入结束，返回是否得到了一个完整的值
+      bool finish() {
+        if (failed) return false;
+        // 最后一段输入已经缓存进deferred.text
+        input = {};
+        if (token == lex::scalar) {
+          std::string text = std::move(partial);
+          auto kind = text[0] == '-' || (text[0] >= '0' && text[0] <= '9') ? push_token::number : push_token::literal;
+          if (!finish_token(kind, text, 0)) return false;
+        }
+        if (token == lex::string || state != expect::done) return error("incomplete input", 0);
+        return true;
+      }
+
+      bool done() const { return !failed && token == lex::none && state == expect::done; }
+    };
+  }
+  using PushParser = json::PushParser;
+}
+
+#endif
@@ -6,8 +6,13 @@
 #include <string_view>
 #include <functional>
 #include <sstream>
+#include <iostream>
 #include <any>
 #include <memory>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
 #include <experimental/type_traits>
 
 #define YURI_ERROR std::cerr << __FILE__ << ':' << __LINE__ << '[' << __PRETTY_FUNCTION__ << ']'
@@ -40,9 +45,9 @@ namespace reflect {
   template<typename _T>
   class Identifier {
    private:
-    static void _id() {}
+    static constexpr char _id{};
    public:
-    inline static const auto ID = reinterpret_cast<const void *>(&Identifier<_T>::_id);
+    static constexpr TypeID ID = &Identifier<_T>::_id;
   };
   // 判断某个type_id是否T类型
   template<typename _T>
@@ -51,7 +56,7 @@ namespace reflect {
   }
   // 字段信息，包括字段名、该字段的类型ID，该字段的偏移量
   struct FieldInfo {
-    const char *name;
+    std::string_view name;
     TypeID type_id;
     size_t offset;
     template<typename T>
@@ -60,7 +65,144 @@ namespace reflect {
 
   // 简化获取type_id的代码
   template<typename T>
-  inline static const TypeID type_id = Identifier<T>::ID;
+  inline static constexpr TypeID type_id = Identifier<T>::ID;
+
+  // 所有handler_table的冻结回调
+  struct freeze_list {
+    std::mutex mutex;
+    std::vector<std::function<void()>> tables;
+    bool frozen = false;
+  };
+  inline freeze_list &get_freeze_list() {
+    static freeze_list list;
+    return list;
+  }
+
+  // type_id到处理函数的表，找不到时返回nullptr，V是指针类型
+  // 注册写入开放寻址的散列表，槽位是原子变量，读取不加锁；扩容时换成新表再原子地发布，
+  // 旧表可能仍有线程在读，保留到handler_table析构，容量按倍数增长，旧表总大小不超过当前表
+  // freeze()之后另外生成按type_id排序的紧凑数组，读取是一次原子load加二分查找；
+  // 之后的注册仍写入散列表，数组中查不到时再查散列表，已经冻结的处理函数不能替换
+  template<typename V>
+  class handler_table {
+    struct slot {
+      std::atomic<TypeID> key{nullptr};
+      std::atomic<V> value{nullptr};
+    };
+    // 容量是2的幂，装载率不超过1/2，保证探测总能遇到空槽
+    struct hash_table {
+      size_t bits;
+      size_t mask;
+      std::unique_ptr<slot[]> slots;
+      explicit hash_table(size_t bits) : bits(bits), mask((size_t(1) << bits) - 1), slots(new slot[mask + 1]) {}
+    };
+    using table = std::vector<std::pair<TypeID, V>>;
+    std::atomic<hash_table *> current{nullptr};
+    std::vector<std::unique_ptr<hash_table>> tables;
+    size_t count = 0;
+    std::atomic<const table *> frozen{nullptr};
+    std::unique_ptr<const table> published;
+    std::atomic<bool> has_late{false};
+    std::mutex mutex;
+   private:
+    static bool less(const std::pair<TypeID, V> &entry, TypeID id) {
+      return std::less<TypeID>()(entry.first, id);
+    }
+    // 返回key为id的槽，没有时返回探测到的第一个空槽
+    static slot &probe(hash_table &h, TypeID id) {
+      auto i = static_cast<size_t>(reinterpret_cast<uintptr_t>(id) * uint64_t(0x9E3779B97F4A7C15) >> (64 - h.bits));
+      for (;; i = (i + 1) & h.mask) {
+        auto key = h.slots[i].key.load(std::memory_order_acquire);
+        if (key == id || key == nullptr) return h.slots[i];
+      }
+    }
+    // 调用时持有mutex
+    hash_table *grow(hash_table *old) {
+      auto next = std::make_unique<hash_table>(old == nullptr ? 4 : old->bits + 1);
+      if (old != nullptr) {
+        for (size_t i = 0; i <= old->mask; ++i) {
+          if (auto key = old->slots[i].key.load(std::memory_order_relaxed); key != nullptr) {
+            auto &s = probe(*next, key);
+            s.value.store(old->slots[i].value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            s.key.store(key, std::memory_order_relaxed);
+          }
+        }
+      }
+      current.store(next.get(), std::memory_order_release);
+      tables.emplace_back(std::move(next));
+      return tables.back().get();
+    }
+   public:
+    handler_table() {
+      auto &list = get_freeze_list();
+      std::lock_guard<std::mutex> lock(list.mutex);
+      list.tables.emplace_back([this]() { freeze(); });
+      if (list.frozen) freeze();
+    }
+    handler_table(const handler_table &) = delete;
+    handler_table &operator=(const handler_table &) = delete;
+
+    void insert(TypeID id, V value) {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto t = frozen.load(std::memory_order_relaxed);
+      if (t != nullptr) {
+        auto it = std::lower_bound(t->begin(), t->end(), id, less);
+        if (it != t->end() && it->first == id) return;
+      }
+      auto h = current.load(std::memory_order_relaxed);
+      if (h != nullptr) {
+        if (auto &s = probe(*h, id); s.key.load(std::memory_order_relaxed) == id) {
+          s.value.store(value, std::memory_order_release);
+          return;
+        }
+      }
+      if (h == nullptr || (count + 1) * 2 > h->mask + 1) h = grow(h);
+      // 先写value再发布key，读到key的线程一定能读到value
+      auto &s = probe(*h, id);
+      s.value.store(value, std::memory_order_relaxed);
+      s.key.store(id, std::memory_order_release);
+      ++count;
+      if (t != nullptr) has_late.store(true, std::memory_order_release);
+    }
+
+    V find(TypeID id) const {
+      if (auto t = frozen.load(std::memory_order_acquire); t != nullptr) {
+        auto it = std::lower_bound(t->begin(), t->end(), id, less);
+        if (it != t->end() && it->first == id) return it->second;
+        if (!has_late.load(std::memory_order_acquire)) return nullptr;
+      }
+      auto h = current.load(std::memory_order_acquire);
+      if (h == nullptr) return nullptr;
+      auto &s = probe(*h, id);
+      return s.key.load(std::memory_order_relaxed) == id ? s.value.load(std::memory_order_acquire) : nullptr;
+    }
+
+    void freeze() {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (frozen.load(std::memory_order_relaxed) != nullptr) return;
+      table t;
+      t.reserve(count);
+      if (auto h = current.load(std::memory_order_relaxed); h != nullptr) {
+        for (size_t i = 0; i <= h->mask; ++i) {
+          if (auto key = h->slots[i].key.load(std::memory_order_relaxed); key != nullptr) {
+            t.emplace_back(key, h->slots[i].value.load(std::memory_order_relaxed));
+          }
+        }
+      }
+      std::sort(t.begin(), t.end(), [](auto &a, auto &b) { return std::less<TypeID>()(a.first, b.first); });
+      published = std::make_unique<const table>(std::move(t));
+      frozen.store(published.get(), std::memory_order_release);
+    }
+  };
+
+  // 所有类型注册完后调用一次，把各个handler表转换成排序的紧凑数组，查找更快；
+  // 不调用时多线程读取同样安全，只是每次查找都要在散列表中探测
+  inline void freeze() {
+    auto &list = get_freeze_list();
+    std::lock_guard<std::mutex> lock(list.mutex);
+    list.frozen = true;
+    for (auto &table : list.tables) table();
+  }
 
   // 判断是否可迭代
   template<typename D>
@@ -82,6 +224,13 @@ namespace reflect {
   template<typename D>
   constexpr bool is_shared_ptr_v =
       std::experimental::is_detected_v<has_unique_t, D> && std::experimental::is_detected_v<has_use_count_t, D>;
+  // 判断是否char字符串，包括std::pmr::string等使用其他allocator的basic_string
+  template<typename D>
+  struct is_char_string : std::false_type {};
+  template<typename Traits, typename Alloc>
+  struct is_char_string<std::basic_string<char, Traits, Alloc>> : std::true_type {};
+  template<typename D>
+  constexpr bool is_char_string_v = is_char_string<D>::value;
 
 
 
@@ -177,15 +326,15 @@ public: \
   if (auto it = _name_to_type_id.find(field_name); it == _name_to_type_id.end()){\
     throw std::runtime_error("unknown_field");\
   } else {\
-    return Serializer::serialize_by_type_id(it->second, ((char*)this) + _name_to_offset[field_name]);\
+    return reflect::Serializer::serialize_by_type_id(it->second, ((char*)this) + _name_to_offset[field_name]);\
   }\
  }\
- bool set_field_from_string(std::string_view field_name, const std::string& value){\
+ bool set_field_from_string(std::string_view field_name, std::string_view value){\
   if (auto it = _name_to_type_id.find(field_name); it == _name_to_type_id.end()){\
     throw std::runtime_error("unknown_field");\
   } else {\
     size_t off = 0;\
-    return Deserializer::parse(it->second, value , off, ((char*)this) + _name_to_offset[field_name]);\
+    return reflect::Deserializer::parse(it->second, value , off, ((char*)this) + _name_to_offset[field_name]);\
   }\
  }\
  static const std::vector<reflect::FieldInfo>& get_field_info_vec() {return _field_info_vec;}\
@@ -1,6 +1,7 @@
 #ifndef LIBYURI__SERIALIZER_H_
 #define LIBYURI__SERIALIZER_H_
 
+#include <charconv>
 #include "reflect.h"
 
 namespace reflect {
@@ -10,22 +11,30 @@ namespace reflect {
 
   namespace json {
 
-    // 序列化函数类型，传入一个void*，返回一个string
-    using serialize_func = std::string(*)(const void *);
+    // 序列化函数类型，传入一个void*，把结果追加到out末尾
+    using serialize_func = void (*)(std::string &out, const void *);
 
     template<typename T>
-    inline static std::string serialize(const void *);
+    inline static void serialize_to(std::string &out, const void *);
 
     class Serializer {
      public:
-      inline static std::unordered_map<reflect::TypeID, serialize_func> handler;
+      static handler_table<serialize_func> &handler() {
+        static handler_table<serialize_func> table;
+        return table;
+      }
      public:
-      inline static std::string serialize_by_type_id(TypeID id, const void *ptr) {
-        if (auto it = handler.find(id); it != handler.end()) {
-          return it->second(ptr);
+      inline static void serialize_by_type_id(TypeID id, std::string &out, const void *ptr) {
+        if (auto func = handler().find(id); func != nullptr) {
+          return func(out, ptr);
         }
         throw std::runtime_error("can not serialize");
       }
+      inline static std::string serialize_by_type_id(TypeID id, const void *ptr) {
+        std::string out;
+        serialize_by_type_id(id, out, ptr);
+        return out;
+      }
       template<typename _T>
       static void register_handler() {
         // 注册所有类型，包括无限定符、const、volatile、cv
@@ -33,84 +42,99 @@ namespace reflect {
         using CT = std::add_const_t<T>;
         using VT = std::add_volatile_t<T>;
         using CVT = std::add_cv_t<T>;
-        handler[type_id<T>] = handler[type_id<CT>] = handler[type_id<VT>] = handler[type_id<CVT>] = serialize<T>;
+        for (auto id : {type_id<T>, type_id<CT>, type_id<VT>, type_id<CVT>}) {
+          handler().insert(id, serialize_to<T>);
+        }
       }
     };
 
+    // 用std::to_chars直接写到out末尾，浮点数使用可往返的最短表示
+    template<typename T>
+    inline void serialize_number(std::string &out, T val) {
+      char buf[64];
+      auto result = std::to_chars(buf, buf + sizeof(buf), val);
+      out.append(buf, result.ptr - buf);
+    }
+
     template<typename _T>
-    inline static std::string serialize(const void *ptr) {
+    inline static void serialize_to(std::string &out, const void *ptr) {
       using T = std::remove_cv_t<_T>;
       const T &val = *static_cast<const T *>(ptr);
       // 字符串类型
-      if constexpr (std::is_same_v<T, std::string>) {
-        return '"' + val + '"';
+      if constexpr (is_char_string_v<T>) {
+        out += '"';
+        out += val;
+        out += '"';
       }
         // bool类型
       else if constexpr (std::is_same_v<T, bool>) {
-        return val ? "true" : "false";
+        out += val ? "true" : "false";
       }
         // 算术类型
       else if constexpr (std::is_arithmetic_v<T>) {
-        return std::to_string(val);
+        serialize_number(out, val);
       }
         // 指针类型，解一次引用再序列化
       else if constexpr (std::is_pointer_v<T>) {
         using element_type = std::remove_pointer_t<T>;
-        if (val == nullptr) return std::string("null");
-        return serialize<element_type>(val);
+        if (val == nullptr) {
+          out += "null";
+        } else {
+          serialize_to<element_type>(out, val);
+        }
       }
         // 智能指针类型
       else if constexpr (is_shared_ptr_v<T>) {
         using element_type = typename T::element_type;
-        if (val == nullptr) return std::string("null");
-        return serialize<element_type>(val.get());
+        if (val == nullptr) {
+          out += "null";
+        } else {
+          serialize_to<element_type>(out, val.get());
+        }
       }
         // 枚举类型
       else if constexpr (std::is_enum_v<T>) {
-        return std::to_string(val);
+        serialize_number(out, static_cast<std::underlying_type_t<T>>(val));
       }
         // 检测有无get_field_info_vec()，如果有，代表是object类型
       else if constexpr(std::experimental::is_detected_v<has_get_field_info_t, T>) {
-        std::stringstream ss;
-        ss << "{";
+        out += '{';
         // 遍历所有字段并序列化
-        for (auto it = val.get_field_info_vec().begin(), end = val.get_field_info_vec().end();;) {
-          ss << '"' << it->name << '"' << ':'
-             << Serializer::serialize_by_type_id(it->type_id, ((char *) (&val)) + it->offset);
-          it++;
-          if (it == end)break;
-          ss << ",";
+        bool first = true;
+        for (auto &field : val.get_field_info_vec()) {
+          if (!first) out += ',';
+          first = false;
+          out += '"';
+          out += field.name;
+          out += "\":";
+          Serializer::serialize_by_type_id(field.type_id, out, ((const char *) (&val)) + field.offset);
         }
-        ss << "}";
-        return ss.str();
+        out += '}';
       } else {
         // 检测有无begin()、end()，如果有，则是可遍历类型
         if constexpr (std::experimental::is_detected_v<has_begin_t, T>
             && std::experimental::is_detected_v<has_end_t, T>) {
           using value_type = typename T::value_type;
-          std::stringstream ss;
-          ss << '[';
+          out += '[';
           // 遍历所有数据并序列化
-          for (auto it = val.begin(), end = val.end();;) {
-            ss << serialize<value_type>(&(*it));
-            it++;
-            if (it == end)break;
-            ss << ',';
+          bool first = true;
+          for (auto &elem : val) {
+            if (!first) out += ',';
+            first = false;
+            serialize_to<value_type>(out, &elem);
           }
-          ss << ']';
-          return ss.str();
+          out += ']';
         }
           // 检测有无first、second成员，如果有，则是pair类型
         else if constexpr (std::experimental::is_detected_v<has_first_t, T>
             && std::experimental::is_detected_v<has_second_t, T>) {
           using first_type = typename T::first_type;
           using second_type = typename T::second_type;
-          std::stringstream ss;
-          ss << '{' << '"' << "first" << '"' << ':' << serialize<first_type>(&val.first)
-             << ',' << '"' << "second" << '"' << ':' << serialize<second_type>(&val.second)
-             << '}';
-          return ss.str();
-
+          out += "{\"first\":";
+          serialize_to<first_type>(out, &val.first);
+          out += ",\"second\":";
+          serialize_to<second_type>(out, &val.second);
+          out += '}';
         }
           // 不是任何一种可序列化的类型，报错
         else {
@@ -118,6 +142,13 @@ namespace reflect {
         }
       }
     }
+
+    template<typename T>
+    inline static std::string serialize(const void *ptr) {
+      std::string out;
+      serialize_to<T>(out, ptr);
+      return out;
+    }
   }
   using Serializer = json::Serializer;
   template<typename T>
@@ -6,8 +6,13 @@
 #include <string_view>
 #include <functional>
 #include <sstream>
+#include <iostream>
 #include <any>
 #include <memory>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
 #include <experimental/type_traits>
 
 #define YURI_ERROR std::cerr << __FILE__ << ':' << __LINE__ << '[' << __PRETTY_FUNCTION__ << ']'
@@ -40,9 +45,9 @@ namespace reflect {
   template<typename _T>
   class Identifier {
    private:
-    static void _id() {}
+    static constexpr char _id{};
    public:
-    inline static const auto ID = reinterpret_cast<const void *>(&Identifier<_T>::_id);
+    static constexpr TypeID ID = &Identifier<_T>::_id;
   };
   // 判断某个type_id是否T类型
   template<typename _T>
@@ -51,7 +56,7 @@ namespace reflect {
   }
   // 字段信息，包括字段名、该字段的类型ID，该字段的偏移量
   struct FieldInfo {
-    const char *name;
+    std::string_view name;
     TypeID type_id;
     size_t offset;
     template<typename T>
@@ -60,7 +65,144 @@ namespace reflect {
 
   // 简化获取type_id的代码
   template<typename T>
-  inline static const TypeID type_id = Identifier<T>::ID;
+  inline static constexpr TypeID type_id = Identifier<T>::ID;
+
+  // 所有handler_table的冻结回调
+  struct freeze_list {
+    std::mutex mutex;
+    std::vector<std::function<void()>> tables;
+    bool frozen = false;
+  };
+  inline freeze_list &get_freeze_list() {
+    static freeze_list list;
+    return list;
+  }
+
+  // type_id到处理函数的表，找不到时返回nullptr，V是指针类型
+  // 注册写入开放寻址的散列表，槽位是原子变量，读取不加锁；扩容时换成新表再原子地发布，
+  // 旧表可能仍有线程在读，保留到handler_table析构，容量按倍数增长，旧表总大小不超过当前表
+  // freeze()之后另外生成按type_id排序的紧凑数组，读取是一次原子load加二分查找；
+  // 之后的注册仍写入散列表，数组中查不到时再查散列表，已经冻结的处理函数不能替换
+  template<typename V>
+  class handler_table {
+    struct slot {
+      std::atomic<TypeID> key{nullptr};
+      std::atomic<V> value{nullptr};
+    };
+    // 容量是2的幂，装载率不超过1/2，保证探测总能遇到空槽
+    struct hash_table {
+      size_t bits;
+      size_t mask;
+      std::unique_ptr<slot[]> slots;
+      explicit hash_table(size_t bits) : bits(bits), mask((size_t(1) << bits) - 1), slots(new slot[mask + 1]) {}
+    };
+    using table = std::vector<std::pair<TypeID, V>>;
+    std::atomic<hash_table *> current{nullptr};
+    std::vector<std::unique_ptr<hash_table>> tables;
+    size_t count = 0;
+    std::atomic<const table *> frozen{nullptr};
+    std::unique_ptr<const table> published;
+    std::atomic<bool> has_late{false};
+    std::mutex mutex;
+   private:
+    static bool less(const std::pair<TypeID, V> &entry, TypeID id) {
+      return std::less<TypeID>()(entry.first, id);
+    }
+    // 返回key为id的槽，没有时返回探测到的第一个空槽
+    static slot &probe(hash_table &h, TypeID id) {
+      auto i = static_cast<size_t>(reinterpret_cast<uintptr_t>(id) * uint64_t(0x9E3779B97F4A7C15) >> (64 - h.bits));
+      for (;; i = (i + 1) & h.mask) {
+        auto key = h.slots[i].key.load(std::memory_order_acquire);
+        if (key == id || key == nullptr) return h.slots[i];
+      }
+    }
+    // 调用时持有mutex
+    hash_table *grow(hash_table *old) {
+      auto next = std::make_unique<hash_table>(old == nullptr ? 4 : old->bits + 1);
+      if (old != nullptr) {
+        for (size_t i = 0; i <= old->mask; ++i) {
+          if (auto key = old->slots[i].key.load(std::memory_order_relaxed); key != nullptr) {
+            auto &s = probe(*next, key);
+            s.value.store(old->slots[i].value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            s.key.store(key, std::memory_order_relaxed);
+          }
+        }
+      }
+      current.store(next.get(), std::memory_order_release);
+      tables.emplace_back(std::move(next));
+      return tables.back().get();
+    }
+   public:
+    handler_table() {
+      auto &list = get_freeze_list();
+      std::lock_guard<std::mutex> lock(list.mutex);
+      list.tables.emplace_back([this]() { freeze(); });
+      if (list.frozen) freeze();
+    }
+    handler_table(const handler_table &) = delete;
+    handler_table &operator=(const handler_table &) = delete;
+
+    void insert(TypeID id, V value) {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto t = frozen.load(std::memory_order_relaxed);
+      if (t != nullptr) {
+        auto it = std::lower_bound(t->begin(), t->end(), id, less);
+        if (it != t->end() && it->first == id) return;
+      }
+      auto h = current.load(std::memory_order_relaxed);
+      if (h != nullptr) {
+        if (auto &s = probe(*h, id); s.key.load(std::memory_order_relaxed) == id) {
+          s.value.store(value, std::memory_order_release);
+          return;
+        }
+      }
+      if (h == nullptr || (count + 1) * 2 > h->mask + 1) h = grow(h);
+      // 先写value再发布key，读到key的线程一定能读到value
+      auto &s = probe(*h, id);
+      s.value.store(value, std::memory_order_relaxed);
+      s.key.store(id, std::memory_order_release);
+      ++count;
+      if (t != nullptr) has_late.store(true, std::memory_order_release);
+    }
+
+    V find(TypeID id) const {
+      if (auto t = frozen.load(std::memory_order_acquire); t != nullptr) {
+        auto it = std::lower_bound(t->begin(), t->end(), id, less);
+        if (it != t->end() && it->first == id) return it->second;
+        if (!has_late.load(std::memory_order_acquire)) return nullptr;
+      }
+      auto h = current.load(std::memory_order_acquire);
+      if (h == nullptr) return nullptr;
+      auto &s = probe(*h, id);
+      return s.key.load(std::memory_order_relaxed) == id ? s.value.load(std::memory_order_acquire) : nullptr;
+    }
+
+    void freeze() {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (frozen.load(std::memory_order_relaxed) != nullptr) return;
+      table t;
+      t.reserve(count);
+      if (auto h = current.load(std::memory_order_relaxed); h != nullptr) {
+        for (size_t i = 0; i <= h->mask; ++i) {
+          if (auto key = h->slots[i].key.load(std::memory_order_relaxed); key != nullptr) {
+            t.emplace_back(key, h->slots[i].value.load(std::memory_order_relaxed));
+          }
+        }
+      }
+      std::sort(t.begin(), t.end(), [](auto &a, auto &b) { return std::less<TypeID>()(a.first, b.first); });
+      published = std::make_unique<const table>(std::move(t));
+      frozen.store(published.get(), std::memory_order_release);
+    }
+  };
+
+  // 所有类型注册完后调用一次，把各个handler表转换成排序的紧凑数组，查找更快；
+  // 不调用时多线程读取同样安全，只是每次查找都要在散列表中探测
+  inline void freeze() {
+    auto &list = get_freeze_list();
+    std::lock_guard<std::mutex> lock(list.mutex);
+    list.frozen = true;
+    for (auto &table : list.tables) table();
+  }
 
   // 判断是否可迭代
   template<typename D>
@@ -82,6 +224,13 @@ namespace reflect {
   template<typename D>
   constexpr bool is_shared_ptr_v =
       std::experimental::is_detected_v<has_unique_t, D> && std::experimental::is_detected_v<has_use_count_t, D>;
+  // 判断是否char字符串，包括std::pmr::string等使用其他allocator的basic_string
+  template<typename D>
+  struct is_char_string : std::false_type {};
+  template<typename Traits, typename Alloc>
+  struct is_char_string<std::basic_string<char, Traits, Alloc>> : std::true_type {};
+  template<typename D>
+  constexpr bool is_char_string_v = is_char_string<D>::value;
 
 
 
@@ -180,7 +329,7 @@ public: \
     return reflect::Serializer::serialize_by_type_id(it->second, ((char*)this) + _name_to_offset[field_name]);\
   }\
  }\
- bool set_field_from_string(std::string_view field_name, const std::string& value){\
+ bool set_field_from_string(std::string_view field_name, std::string_view value){\
   if (auto it = _name_to_type_id.find(field_name); it == _name_to_type_id.end()){\
     throw std::runtime_error("unknown_field");\
   } else {\
@@ -297,6 +446,7 @@ get_base_map(_field_info_vec);
 #define with_comma(...) __VA_ARGS__
 
 
+#include <charconv>
 
 namespace reflect {
   /*
@@ -305,22 +455,30 @@ namespace reflect {
 
   namespace json {
 
-    // 序列化函数类型，传入一个void*，返回一个string
-    using serialize_func = std::string(*)(const void *);
+    // 序列化函数类型，传入一个void*，把结果追加到out末尾
+    using serialize_func = void (*)(std::string &out, const void *);
 
     template<typename T>
-    inline static std::string serialize(const void *);
+    inline static void serialize_to(std::string &out, const void *);
 
     class Serializer {
      public:
-      inline static std::unordered_map<reflect::TypeID, serialize_func> handler;
+      static handler_table<serialize_func> &handler() {
+        static handler_table<serialize_func> table;
+        return table;
+      }
      public:
-      inline static std::string serialize_by_type_id(TypeID id, const void *ptr) {
-        if (auto it = handler.find(id); it != handler.end()) {
-          return it->second(ptr);
+      inline static void serialize_by_type_id(TypeID id, std::string &out, const void *ptr) {
+        if (auto func = handler().find(id); func != nullptr) {
+          return func(out, ptr);
         }
         throw std::runtime_error("can not serialize");
       }
+      inline static std::string serialize_by_type_id(TypeID id, const void *ptr) {
+        std::string out;
+        serialize_by_type_id(id, out, ptr);
+        return out;
+      }
       template<typename _T>
       static void register_handler() {
         // 注册所有类型，包括无限定符、const、volatile、cv
@@ -328,84 +486,99 @@ namespace reflect {
         using CT = std::add_const_t<T>;
         using VT = std::add_volatile_t<T>;
         using CVT = std::add_cv_t<T>;
-        handler[type_id<T>] = handler[type_id<CT>] = handler[type_id<VT>] = handler[type_id<CVT>] = serialize<T>;
+        for (auto id : {type_id<T>, type_id<CT>, type_id<VT>, type_id<CVT>}) {
+          handler().insert(id, serialize_to<T>);
+        }
       }
     };
 
+    // 用std::to_chars直接写到out末尾，浮点数使用可往返的最短表示
+    template<typename T>
+    inline void serialize_number(std::string &out, T val) {
+      char buf[64];
+      auto result = std::to_chars(buf, buf + sizeof(buf), val);
+      out.append(buf, result.ptr - buf);
+    }
+
     template<typename _T>
-    inline static std::string serialize(const void *ptr) {
+    inline static void serialize_to(std::string &out, const void *ptr) {
       using T = std::remove_cv_t<_T>;
       const T &val = *static_cast<const T *>(ptr);
       // 字符串类型
-      if constexpr (std::is_same_v<T, std::string>) {
-        return '"' + val + '"';
+      if constexpr (is_char_string_v<T>) {
+        out += '"';
+        out += val;
+        out += '"';
       }
         // bool类型
       else if constexpr (std::is_same_v<T, bool>) {
-        return val ? "true" : "false";
+        out += val ? "true" : "false";
       }
         // 算术类型
       else if constexpr (std::is_arithmetic_v<T>) {
-        return std::to_string(val);
+        serialize_number(out, val);
       }
         // 指针类型，解一次引用再序列化
       else if constexpr (std::is_pointer_v<T>) {
         using element_type = std::remove_pointer_t<T>;
-        if (val == nullptr) return std::string("null");
-        return serialize<element_type>(val);
+        if (val == nullptr) {
+          out += "null";
+        } else {
+          serialize_to<element_type>(out, val);
+        }
       }
         // 智能指针类型
       else if constexpr (is_shared_ptr_v<T>) {
         using element_type = typename T::element_type;
-        if (val == nullptr) return std::string("null");
-        return serialize<element_type>(val.get());
+        if (val == nullptr) {
+          out += "null";
+        } else {
+          serialize_to<element_type>(out, val.get());
+        }
       }
         // 枚举类型
       else if constexpr (std::is_enum_v<T>) {
-        return std::to_string(val);
+        serialize_number(out, static_cast<std::underlying_type_t<T>>(val));
       }
         // 检测有无get_field_info_vec()，如果有，代表是object类型
       else if constexpr(std::experimental::is_detected_v<has_get_field_info_t, T>) {
-        std::stringstream ss;
-        ss << "{";
+        out += '{';
         // 遍历所有字段并序列化
-        for (auto it = val.get_field_info_vec().begin(), end = val.get_field_info_vec().end();;) {
-          ss << '"' << it->name << '"' << ':'
-             << Serializer::serialize_by_type_id(it->type_id, ((char *) (&val)) + it->offset);
-          it++;
-          if (it == end)break;
-          ss << ",";
-        }
-        ss << "}";
-        return ss.str();
+        bool first = true;
+        for (auto &field : val.get_field_info_vec()) {
+          if (!first) out += ',';
+          first = false;
+          out += '"';
+          out += field.name;
+          out += "\":";
+          Serializer::serialize_by_type_id(field.type_id, out, ((const char *) (&val)) + field.offset);
+        }
+        out += '}';
       } else {
         // 检测有无begin()、end()，如果有，则是可遍历类型
         if constexpr (std::experimental::is_detected_v<has_begin_t, T>
             && std::experimental::is_detected_v<has_end_t, T>) {
           using value_type = typename T::value_type;
-          std::stringstream ss;
-          ss << '[';
+          out += '[';
           // 遍历所有数据并序列化
-          for (auto it = val.begin(), end = val.end();;) {
-            ss << serialize<value_type>(&(*it));
-            it++;
-            if (it == end)break;
-            ss << ',';
+          bool first = true;
+          for (auto &elem : val) {
+            if (!first) out += ',';
+            first = false;
+            serialize_to<value_type>(out, &elem);
           }
-          ss << ']';
-          return ss.str();
+          out += ']';
         }
           // 检测有无first、second成员，如果有，则是pair类型
         else if constexpr (std::experimental::is_detected_v<has_first_t, T>
             && std::experimental::is_detected_v<has_second_t, T>) {
           using first_type = typename T::first_type;
           using second_type = typename T::second_type;
-          std::stringstream ss;
-          ss << '{' << '"' << "first" << '"' << ':' << serialize<first_type>(&val.first)
-             << ',' << '"' << "second" << '"' << ':' << serialize<second_type>(&val.second)
-             << '}';
-          return ss.str();
-
+          out += "{\"first\":";
+          serialize_to<first_type>(out, &val.first);
+          out += ",\"second\":";
+          serialize_to<second_type>(out, &val.second);
+          out += '}';
         }
           // 不是任何一种可序列化的类型，报错
         else {
@@ -413,6 +586,13 @@ namespace reflect {
         }
       }
     }
+
+    template<typename T>
+    inline static std::string serialize(const void *ptr) {
+      std::string out;
+      serialize_to<T>(out, ptr);
+      return out;
+    }
   }
   using Serializer = json::Serializer;
   template<typename T>
@@ -422,6 +602,14 @@ namespace reflect {
 }
 
 #include <iostream>
+#include <cstdint>
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <memory_resource>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #define PARSE_ERROR(what) YURI_ERROR << "parse " << what << " failed. str = " << (std::string(str).insert(off,"\e[31m").insert(str.size(),"\e[0m")) << ", off = " << off  << "\n"
 #define PARSE_SPACE() if (!parse_space(str, off)){PARSE_ERROR("space");return false;}
@@ -432,14 +620,14 @@ namespace reflect {
   * 反序列化
   */
     // parse函数类型，传入要解析的字符串、偏移量、要赋值的地址
-    using parse_func = bool (*)(const std::string &, size_t &off, void *);
+    using parse_func = bool (*)(std::string_view, size_t &off, void *);
 
     // 对于null，调用parse_unknown_field会解析成该类型
     struct null {};
     // 前向声明
     template<typename T>
-    inline static bool deserialize(const std::string &, size_t &off, void *ptr);
-    inline bool parse_space(const std::string &str, size_t &off);
+    inline static bool deserialize(std::string_view, size_t &off, void *ptr);
+    inline bool parse_space(std::string_view str, size_t &off);
 
     inline bool isspace(char c) {
       switch (c) {
@@ -453,17 +641,306 @@ namespace reflect {
       }
     }
 
+    // 对64字节的块按字符分类，每个掩码的第i位对应块内第i个字节
+    struct BlockMasks {
+      uint64_t whitespace;
+      // 结构字符：{ } [ ] , :
+      uint64_t structural;
+      uint64_t quote;
+      uint64_t backslash;
+    };
+
+    inline BlockMasks classify_block(const char *block) {
+      BlockMasks masks{0, 0, 0, 0};
+#if defined(__SSE2__)
+      const __m128i space = _mm_set1_epi8(' ');
+      const __m128i tab = _mm_set1_epi8('\t');
+      const __m128i four = _mm_set1_epi8(4);
+      const __m128i quote = _mm_set1_epi8('"');
+      const __m128i backslash = _mm_set1_epi8('\\');
+      for (int i = 0; i < 4; i++) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i * 16));
+        // \t \n \v \f \r是连续的0x09~0x0D
+        __m128i control = _mm_sub_epi8(chunk, tab);
+        __m128i ws = _mm_or_si128(_mm_cmpeq_epi8(chunk, space),
+                                  _mm_cmpeq_epi8(_mm_min_epu8(control, four), control));
+        __m128i st = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('{')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('}'))),
+            _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('[')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8(']'))),
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(',')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8(':')))));
+        auto shift = i * 16;
+        masks.whitespace |= uint64_t(uint16_t(_mm_movemask_epi8(ws))) << shift;
+        masks.structural |= uint64_t(uint16_t(_mm_movemask_epi8(st))) << shift;
+        masks.quote |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote)))) << shift;
+        masks.backslash |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, backslash)))) << shift;
+      }
+#else
+      for (int i = 0; i < 64; i++) {
+        auto bit = uint64_t(1) << i;
+        switch (block[i]) {
+          case '{':
+          case '}':
+          case '[':
+          case ']':
+          case ',':
+          case ':':masks.structural |= bit;
+            break;
+          case '"':masks.quote |= bit;
+            break;
+          case '\\':masks.backslash |= bit;
+            break;
+          default:
+            if (isspace(block[i])) masks.whitespace |= bit;
+        }
+      }
+#endif
+      return masks;
+    }
+
+    // 分类str从off开始的64字节，不足64字节的部分用'\0'填充（'\0'不属于任何一类）
+    inline BlockMasks classify_at(std::string_view str, size_t off) {
+      if (str.size() - off >= 64) {
+        return classify_block(str.data() + off);
+      }
+      char block[64] = {};
+      std::memcpy(block, str.data() + off, str.size() - off);
+      return classify_block(block);
+    }
+
+    // 最近一次分类的块，起点是相对str开头的64字节对齐位置
+    // 同一块内的多次查找（跳过缩进、扫描短字符串）共用一次分类，只做移位和ctz
+    struct BlockCache {
+      const char *data = nullptr;
+      size_t size = 0;
+      size_t start = 0;
+      BlockMasks masks{};
+      // 嵌套的block_scope个数，为0时不使用缓存
+      size_t depth = 0;
+    };
+
+    inline BlockCache &block_cache() {
+      thread_local BlockCache cache;
+      return cache;
+    }
+
+    // 缓存只在一次解析期间有效，最外层的block_scope进入时清空
+    // 两次解析之间同一块内存可能写入了新内容，只凭地址和长度无法区分
+    class block_scope {
+     public:
+      block_scope() {
+        auto &cache = block_cache();
+        if (cache.depth++ == 0) cache.data = nullptr;
+      }
+      block_scope(const block_scope &) = delete;
+      block_scope &operator=(const block_scope &) = delete;
+      ~block_scope() { block_cache().depth--; }
+    };
+
+    // 在一次解析中途解析另一段输入，两段输入可能先后使用同一块内存，离开时恢复外层的缓存
+    class isolated_block_scope {
+      BlockCache saved;
+     public:
+      isolated_block_scope() : saved(block_cache()) {
+        auto &cache = block_cache();
+        cache.data = nullptr;
+        cache.depth++;
+      }
+      isolated_block_scope(const isolated_block_scope &) = delete;
+      isolated_block_scope &operator=(const isolated_block_scope &) = delete;
+      ~isolated_block_scope() { block_cache() = saved; }
+    };
+
+    inline BlockMasks classify_cached(std::string_view str, size_t start) {
+      auto &cache = block_cache();
+      if (cache.depth == 0) return classify_at(str, start);
+      if (cache.data != str.data() || cache.size != str.size() || cache.start != start) {
+        cache.masks = classify_at(str, start);
+        cache.data = str.data();
+        cache.size = str.size();
+        cache.start = start;
+      }
+      return cache.masks;
+    }
+
+    // 从off开始找到第一个在mask_of(masks)中的字节，找不到时返回str.size()
+    template<typename MaskOf>
+    inline size_t find_in_blocks(std::string_view str, size_t off, MaskOf mask_of) {
+      if (off >= str.size()) return str.size();
+      size_t start = off & ~size_t(63);
+      // 第一块去掉off之前的字节
+      if (auto mask = mask_of(classify_cached(str, start)) >> (off - start); mask != 0) {
+        return std::min(off + __builtin_ctzll(mask), str.size());
+      }
+      for (start += 64; start < str.size(); start += 64) {
+        if (auto mask = mask_of(classify_cached(str, start)); mask != 0) {
+          return std::min(start + __builtin_ctzll(mask), str.size());
+        }
+      }
+      return str.size();
+    }
+
+    // 跳过未知值时用到的分类，open是{ [，close是} ]
+    struct BracketMasks {
+      uint64_t open;
+      uint64_t close;
+      uint64_t quote;
+      uint64_t backslash;
+    };
+
+    // 分类str从off开始的64字节，超出str的部分不属于任何一类
+    inline BracketMasks classify_brackets(std::string_view str, size_t off) {
+      const char *block = str.data() + off;
+      char padded[64] = {};
+      if (str.size() - off < 64) {
+        std::memcpy(padded, block, str.size() - off);
+        block = padded;
+      }
+      BracketMasks masks{0, 0, 0, 0};
+#if defined(__SSE2__)
+      for (int i = 0; i < 4; i++) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i * 16));
+        __m128i open = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('{')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('[')));
+        __m128i close = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('}')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8(']')));
+        auto shift = i * 16;
+        masks.open |= uint64_t(uint16_t(_mm_movemask_epi8(open))) << shift;
+        masks.close |= uint64_t(uint16_t(_mm_movemask_epi8(close))) << shift;
+        masks.quote |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"'))))) << shift;
+        masks.backslash |=
+            uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'))))) << shift;
+      }
+#else
+      for (int i = 0; i < 64; i++) {
+        auto bit = uint64_t(1) << i;
+        switch (block[i]) {
+          case '{':
+          case '[':masks.open |= bit;
+            break;
+          case '}':
+          case ']':masks.close |= bit;
+            break;
+          case '"':masks.quote |= bit;
+            break;
+          case '\\':masks.backslash |= bit;
+            break;
+          default:break;
+        }
+      }
+#endif
+      return masks;
+    }
+
+    // 跳过off处的对象或数组，每次处理64字节：先算出哪些字节在字符串内，再统计块内的括号
+    // 块内的右括号不足以回到深度0时整块跳过，否则逐个找到深度归零的位置
+    inline bool skip_container(std::string_view str, size_t &off) {
+      size_t depth = 0;
+      // 上一块结尾是否在字符串内，上一块最后一个字节是否是未被转义的反斜杠
+      uint64_t in_string = 0;
+      uint64_t escape_next = 0;
+      for (size_t pos = off; pos < str.size(); pos += 64) {
+        auto masks = classify_brackets(str, pos);
+        // 被转义的字符，反斜杠通常很少，逐个处理
+        uint64_t escaped = escape_next;
+        escape_next = 0;
+        for (uint64_t bs = masks.backslash & ~escaped; bs != 0; bs &= bs - 1) {
+          auto bit = bs & -bs;
+          if (bit == uint64_t(1) << 63) {
+            escape_next = 1;
+          } else {
+            escaped |= bit << 1;
+            // 被转义的反斜杠不再转义下一个字符
+            bs &= ~(bit << 1);
+          }
+        }
+        // 前缀异或：字符串内的字节（包括开头的引号，不包括结尾的引号）为1
+        uint64_t quotes = masks.quote & ~escaped;
+        uint64_t inside = quotes;
+        for (int shift = 1; shift < 64; shift <<= 1) inside ^= inside << shift;
+        inside ^= in_string;
+        in_string = uint64_t(int64_t(inside) >> 63);
+        uint64_t open = masks.open & ~inside;
+        uint64_t close = masks.close & ~inside;
+        if (size_t(__builtin_popcountll(close)) < depth) {
+          depth += __builtin_popcountll(open) - __builtin_popcountll(close);
+          continue;
+        }
+        for (uint64_t brackets = open | close; brackets != 0; brackets &= brackets - 1) {
+          auto bit = brackets & -brackets;
+          if (open & bit) {
+            depth++;
+          } else if (--depth == 0) {
+            auto end = pos + __builtin_ctzll(bit) + 1;
+            if (end > str.size()) return false;
+            off = end;
+            return true;
+          }
+        }
+      }
+      return false;
+    }
+
+    // 当前线程反序列化时使用的memory_resource，nullptr时使用默认的new/delete
+    inline std::pmr::memory_resource *&current_resource() {
+      thread_local std::pmr::memory_resource *resource = nullptr;
+      return resource;
+    }
+
+    // 在作用域内，当前线程解析出的智能指针指向的对象、pmr字符串和容器都从resource分配
+    // 解析出的对象需要在resource之前销毁
+    class ResourceScope {
+      std::pmr::memory_resource *saved;
+     public:
+      explicit ResourceScope(std::pmr::memory_resource *resource) : saved(current_resource()) {
+        current_resource() = resource;
+      }
+      ResourceScope(const ResourceScope &) = delete;
+      ResourceScope &operator=(const ResourceScope &) = delete;
+      ~ResourceScope() { current_resource() = saved; }
+    };
+
+    template<typename D>
+    using has_allocator_type_t = typename D::allocator_type;
+
+    // 使用polymorphic_allocator的字符串、容器在解析前换成当前的memory_resource
+    template<typename T>
+    inline void adopt_resource(T &t) {
+      if constexpr (std::experimental::is_detected_v<has_allocator_type_t, T>) {
+        using allocator_type = typename T::allocator_type;
+        if constexpr (std::is_same_v<allocator_type, std::pmr::polymorphic_allocator<typename allocator_type::value_type>>) {
+          auto resource = current_resource();
+          if (resource != nullptr && t.get_allocator().resource() != resource) {
+            // 容器的allocator不随赋值传播，只能重新构造
+            t.~T();
+            new(&t) T(allocator_type(resource));
+          }
+        }
+      }
+    }
+
+    // 智能指针指向的对象，有memory_resource时用allocate_shared，对象和控制块一起从resource分配
+    template<typename T>
+    inline std::shared_ptr<T> make_shared_object() {
+      if (auto resource = current_resource(); resource != nullptr) {
+        return std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(resource));
+      }
+      return std::make_shared<T>();
+    }
+
     // 反序列化类
     class Deserializer {
      public:
       // 管理type_id到parse_func的映射
       // 初始化时注册用于解析unknown_field的函数
-      inline static std::unordered_map<TypeID, parse_func> handler;
+      static handler_table<parse_func> &handler() {
+        static handler_table<parse_func> table;
+        return table;
+      }
      public:
-      inline static bool parse(reflect::TypeID id, const std::string &str, size_t &off, void *ptr) {
+      inline static bool parse(reflect::TypeID id, std::string_view str, size_t &off, void *ptr) {
+        block_scope scope;
         PARSE_SPACE();
-        if (auto it = handler.find(id); it != handler.end()) {
-          return it->second(str, off, ptr);
+        if (auto func = handler().find(id); func != nullptr) {
+          return func(str, off, ptr);
         } else {
           YURI_ERROR << "no such handler\n";
           return false;
@@ -471,14 +948,14 @@ namespace reflect {
       }
       // 解析一个未知的字段
       // 如果out是nullptr，则丢弃解析结果
-      static bool parse_unknown_field(const std::string &str, size_t &off, std::any *out) __attribute__((noinline));
+      static bool parse_unknown_field(std::string_view str, size_t &off, std::any *out) __attribute__((noinline));
       // 注册一个T类型的parse_func到Deserializer的handler中
       template<typename T>
-      inline static void register_handler() { handler[type_id<T>] = deserialize<T>; }
+      inline static void register_handler() { handler().insert(type_id<T>, deserialize<T>); }
     };
 
     template<typename T>
-    inline static T reflect_default_deserialize(const std::string &str) {
+    inline static T reflect_default_deserialize(std::string_view str) {
       size_t off = 0;
       T t;
       if (!Deserializer::parse(type_id<T>, str, off, &t)) {
@@ -487,7 +964,19 @@ namespace reflect {
       return t;
     }
 
-    inline static std::any reflect_deserialize_unknown(const std::string &str) {
+    template<typename T>
+    inline static T reflect_default_deserialize(const char *data, size_t size) {
+      return reflect_default_deserialize<T>(std::string_view(data, size));
+    }
+
+    // 解析过程中的分配都来自resource，例如传入std::pmr::monotonic_buffer_resource，整个对象图一次释放
+    template<typename T>
+    inline static T reflect_default_deserialize(std::string_view str, std::pmr::memory_resource *resource) {
+      ResourceScope scope(resource);
+      return reflect_default_deserialize<T>(str);
+    }
+
+    inline static std::any reflect_deserialize_unknown(std::string_view str) {
       size_t off = 0;
       std::any val;
       if (!Deserializer::parse_unknown_field(str, off, &val)) {
@@ -499,21 +988,89 @@ namespace reflect {
     // 具体实现
 
 
-    // 解析空格
-    inline bool parse_space(const std::string &str, size_t &off) {
-      while (isspace(str[off]) && off < str.size())off++;
+    // 解析空格，紧凑的JSON通常没有空白，先检查一个字节；否则按64字节的块跳到下一个非空白字符
+    inline bool parse_space(std::string_view str, size_t &off) {
+      if (off < str.size() && !isspace(str[off])) return true;
+      off = find_in_blocks(str, off, [](const BlockMasks &masks) { return ~masks.whitespace; });
       return off < str.size();
     }
     // 解析一个字符，如果str[off]是该字符，则解析成功，off自增1并返回true，否则返回false
-    inline bool parse_ch(char ch, const std::string &str, size_t &off) {
+    inline bool parse_ch(char ch, std::string_view str, size_t &off) {
       PARSE_SPACE();
       if (str[off] != ch)return false;
       off++;
       return true;
     }
+    // 用std::from_chars解析数字，与locale无关；解析失败或超出T的范围时返回false且不修改t
+    template<typename T>
+    inline bool parse_number(std::string_view str, size_t &off, T &t) {
+      const char *first = str.data() + off;
+      const char *last = str.data() + str.size();
+      if constexpr (std::is_integral_v<T>) {
+        // 快速路径：不超过digits10位的整数不会溢出，直接逐位累加
+        const char *p = first;
+        bool negative = std::is_signed_v<T> && p != last && *p == '-';
+        if (negative) p++;
+        const char *digits = p;
+        const char *limit = p + std::min<size_t>(last - p, std::numeric_limits<T>::digits10);
+        T val = 0;
+        while (p != limit && static_cast<unsigned char>(*p - '0') < 10) {
+          val = static_cast<T>(val * 10 + (*p++ - '0'));
+        }
+        if (p != digits && (p == last || static_cast<unsigned char>(*p - '0') >= 10)) {
+          t = negative ? static_cast<T>(-val) : val;
+          off = p - str.data();
+          return true;
+        }
+      }
+      auto[ptr, ec] = std::from_chars(first, last, t);
+      if (ec != std::errc() || ptr == first) return false;
+      off = ptr - str.data();
+      return true;
+    }
+    // off指向开头的引号，跳到结尾的引号之后，反斜杠转义其后的一个字符
+    inline bool skip_string(std::string_view str, size_t &off) {
+      auto save = off++;
+      while (true) {
+        off = find_in_blocks(str, off, [](const BlockMasks &masks) { return masks.quote | masks.backslash; });
+        if (off >= str.size() || str[off] == '"') break;
+        off += 2;
+      }
+      if (off >= str.size()) {
+        off = save;
+        return false;
+      }
+      off++;
+      return true;
+    }
+    // 跳过一个值，只跟踪字符串和括号深度，不检查其余语法，不分配内存，也不转换数字
+    inline bool skip_value(std::string_view str, size_t &off) {
+      if (!parse_space(str, off)) return false;
+      if (str[off] == '"') return skip_string(str, off);
+      if (str[off] != '{' && str[off] != '[') {
+        // 数字、true、false、null，到下一个结构字符或空白为止
+        auto end = find_in_blocks(str, off, [](const BlockMasks &masks) { return masks.structural | masks.whitespace; });
+        if (end == off || str[off] == '}' || str[off] == ']') return false;
+        off = end;
+        return true;
+      }
+      return skip_container(str, off);
+    }
+    // 按字段名查找reflect类型T的字段，找不到时返回nullptr；索引在第一次调用时构造
+    template<typename T>
+    inline const FieldInfo *find_field(std::string_view name) {
+      static const auto index = [] {
+        std::unordered_map<std::string_view, const FieldInfo *> index;
+        for (auto &field : T::get_field_info_vec()) index.emplace(field.name, &field);
+        return index;
+      }();
+      auto it = index.find(name);
+      return it == index.end() ? nullptr : it->second;
+    }
 // 获取类型T的反序列化函数
     template<typename T>
-    inline static bool deserialize(const std::string &str, size_t &off, void *ptr) {
+    inline static bool deserialize(std::string_view str, size_t &off, void *ptr) {
+      block_scope scope;
       // bool类型
       if constexpr (std::is_same_v<T, bool>) {
         PARSE_SPACE();
@@ -541,37 +1098,19 @@ namespace reflect {
         }
         return true;
       }
-        // 整数类型，先转为long long，再强转为T
-      else if constexpr (std::is_integral_v<T>) {
-        PARSE_SPACE();
-        auto &t = *static_cast<T *>(ptr);
-        char *end;
-        auto val = strtoll(str.c_str() + off, &end, 10);
-        if (errno != 0 || end == str.c_str()) {
-          PARSE_ERROR("integral");
-          return false;
-        }
-        off = end - str.c_str();
-        t = static_cast<T>(val);
-        return true;
-      }
-        // 浮点类型，先转为double，再强转为T
-      else if constexpr(std::is_floating_point_v<T>) {
+        // 数字类型，直接按T的宽度解析，超出T的范围时失败
+      else if constexpr (std::is_arithmetic_v<T>) {
         PARSE_SPACE();
-        auto &t = *static_cast<T *>(ptr);
-        char *end;
-        auto val = strtof64(str.c_str() + off, &end);
-        if (errno != 0 || end == str.c_str()) {
-          PARSE_ERROR("floating_point");
+        if (!parse_number(str, off, *static_cast<T *>(ptr))) {
+          PARSE_ERROR((std::is_integral_v<T> ? "integral" : "floating_point"));
           return false;
         }
-        off = end - str.c_str();
-        t = static_cast<T>(val);
         return true;
       }
         // 字符串类型
-      else if constexpr(std::is_same_v<T, std::string>) {
+      else if constexpr(is_char_string_v<T>) {
         auto &t = *static_cast<T *>(ptr);
+        adopt_resource(t);
         PARSE_SPACE();
         if (str.size() - off < 2) {
           PARSE_ERROR("string");
@@ -583,8 +1122,12 @@ namespace reflect {
           return false;
         }
         auto save = off;
-        // 字符串内容
-        while ((str[off] != '"' || str[off - 1] == '\\') && off < str.size())off++;
+        // 字符串内容，直接跳到下一个引号或反斜杠，反斜杠转义其后的一个字符
+        while (true) {
+          off = find_in_blocks(str, off, [](const BlockMasks &masks) { return masks.quote | masks.backslash; });
+          if (off >= str.size() || str[off] == '"') break;
+          off += 2;
+        }
         if (off >= str.size()) {
           PARSE_ERROR("string");
           off = save;
@@ -606,6 +1149,7 @@ namespace reflect {
         }
         // 循环解析每一个元素
         auto &vec = *static_cast<T *>(ptr);
+        adopt_resource(vec);
         vec.clear();
         // 该数组中没有元素
         if (parse_ch(']', str, off)) {
@@ -697,29 +1241,40 @@ namespace reflect {
         if (parse_ch('}', str, off)) {
           return true;
         }
-        T &t = *static_cast<T *>(ptr);
+        auto &fields = T::get_field_info_vec();
+        // 序列化端通常按声明顺序输出字段，先猜key是上一个字段的下一个
+        size_t expected = 0;
         // 循环解析字段
         while (true) {
-          // 解析key
-          std::string key;
-          if (!deserialize<std::string>(str, off, &key)) {
-            PARSE_ERROR(key);
+          // 解析key，与deserialize<std::string>一样不处理转义，直接引用输入
+          PARSE_SPACE();
+          auto key_begin = off + 1;
+          if (str[off] != '"' || !skip_string(str, off)) {
+            PARSE_ERROR("key");
             return false;
           }
+          std::string_view key = str.substr(key_begin, off - 1 - key_begin);
           if (!parse_ch(':', str, off)) {
             PARSE_ERROR(":");
             return false;
           }
-          // 不存在该key时，调用parse_unknown_field以解析未知该value并丢弃
-          if (auto id = t.get_type_id_by_name(key); id == nullptr) {
-            if (!Deserializer::parse_unknown_field(str, off, nullptr)) {
-              PARSE_ERROR("unknown field " + key);
+          const FieldInfo *field = nullptr;
+          if (expected < fields.size() && fields[expected].name.size() == key.size()
+              && std::memcmp(fields[expected].name.data(), key.data(), key.size()) == 0) {
+            field = &fields[expected];
+          } else {
+            field = find_field<T>(key);
+          }
+          // 不存在该key时，直接跳过该value
+          if (field == nullptr) {
+            if (!skip_value(str, off)) {
+              PARSE_ERROR("unknown field " + std::string(key));
               return false;
             }
           } else {
-            // 存在该key时，获取该key对应的type_id、偏移量，然后递归调用parse解析
-            size_t offset = t.get_offset_by_name(key);
-            if (!Deserializer::parse(id, str, off, ((char *) ptr) + offset)) {
+            // 存在该key时，按该字段的type_id、偏移量递归调用parse解析
+            expected = field - fields.data() + 1;
+            if (!Deserializer::parse(field->type_id, str, off, ((char *) ptr) + field->offset)) {
               PARSE_ERROR(key);
               return false;
             }
@@ -746,7 +1301,7 @@ namespace reflect {
           off += 4;
           return true;
         }
-        *static_cast<T *>(ptr) = std::make_shared<element_type>();
+        *static_cast<T *>(ptr) = make_shared_object<element_type>();
         if (!deserialize<element_type>(str, off, static_cast<T *>(ptr)->get())) {
           PARSE_ERROR("pointer");
           return false;
@@ -756,7 +1311,15 @@ namespace reflect {
         static_assert(std::experimental::is_detected_v<reflect::has_get_field_info_t, T>, "can not parse");
       }
     }
-    bool Deserializer::parse_unknown_field(const std::string &str, size_t &off, std::any *out) {
+    bool Deserializer::parse_unknown_field(std::string_view str, size_t &off, std::any *out) {
+      block_scope scope;
+      if (out == nullptr) {
+        if (!skip_value(str, off)) {
+          PARSE_ERROR("unknown_field");
+          return false;
+        }
+        return true;
+      }
       PARSE_SPACE();
       switch (str[off]) {
         // 数组
@@ -764,6 +1327,11 @@ namespace reflect {
           // 左中括号
           parse_ch('[', str, off);
           std::vector<std::any> va;
+          // 空数组
+          if (parse_ch(']', str, off)) {
+            *out = std::any(std::move(va));
+            return true;
+          }
           // 循环解析数组内容
           for (;;) {
             std::any val;
@@ -789,6 +1357,11 @@ namespace reflect {
           // 左大括号
           parse_ch('{', str, off);
           Object obj;
+          // 空对象
+          if (parse_ch('}', str, off)) {
+            *out = std::any(std::move(obj));
+            return true;
+          }
           // 循环解析字段
           while (true) {
             std::string key;
@@ -868,7 +1441,7 @@ namespace reflect {
   }
   using Deserializer = json::Deserializer;
   template<typename T>
-  T parse(const std::string &str) {
+  T parse(std::string_view str) {
     size_t off = 0;
     T t;
     if (!json::deserialize<T>(str, off, &t)) {
@@ -876,7 +1449,11 @@ namespace reflect {
     }
     return t;
   }
-  std::any parse(const std::string &str) {
+  template<typename T>
+  T parse(const char *data, size_t size) {
+    return parse<T>(std::string_view(data, size));
+  }
+  inline std::any parse(std::string_view str) {
     size_t off = 0;
     std::any a;
     if (!Deserializer::parse_unknown_field(str, off, &a)) {
@@ -887,4 +1464,1046 @@ namespace reflect {
 }
 #undef PARSE_ERROR
 #undef PARSE_SPACE
+
+namespace reflect {
+  namespace json {
+    /*
+     * 不需要反序列化成具体类型时使用的JSON文档
+     * 所有值按前序存放在一个数组中，字符串直接引用输入，释放整个文档只有一次deallocation
+     */
+
+    enum class value_type : uint8_t { invalid, null, boolean, integer, number, string, array, object };
+
+    // 对象的成员在tape中是key、value交替排列
+    struct tape_node {
+      value_type type;
+      // 字符串的长度，数组的元素个数，对象的成员个数
+      uint32_t size;
+      union {
+        // boolean也存放在这里
+        int64_t integer;
+        double number;
+        // 字符串在输入中的起点
+        uint32_t begin;
+        // 数组、对象之后的第一个节点的下标，用于跳过整个子树
+        uint32_t end;
+      };
+    };
+    static_assert(sizeof(tape_node) == 16);
+
+    class Document;
+    class Value;
+
+    struct Member {
+      std::string_view key;
+      Value value() const;
+      const Document *doc;
+      uint32_t index;
+    };
+
+    // 文档中的一个值，只保存文档指针和下标，可以随意复制
+    // 类型不符时as_xxx返回默认值，不存在的下标或key返回invalid
+    class Value {
+      friend class Document;
+      friend struct Member;
+      const Document *doc = nullptr;
+      uint32_t index = 0;
+      Value(const Document *doc, uint32_t index) : doc(doc), index(index) {}
+      const tape_node &node() const;
+      // 跳过当前值，返回下一个兄弟节点的下标
+      uint32_t next() const;
+     public:
+      Value() = default;
+
+      // 遍历数组的元素或对象的成员
+      template<bool Object>
+      class iterator {
+        friend class Value;
+        const Document *doc;
+        uint32_t index;
+        iterator(const Document *doc, uint32_t index) : doc(doc), index(index) {}
+       public:
+        using value_type = std::conditional_t<Object, Member, Value>;
+        value_type operator*() const;
+        iterator &operator++();
+        bool operator==(const iterator &other) const { return index == other.index; }
+        bool operator!=(const iterator &other) const { return index != other.index; }
+      };
+      template<bool Object>
+      struct range {
+        iterator<Object> first, last;
+        iterator<Object> begin() const { return first; }
+        iterator<Object> end() const { return last; }
+      };
+
+      value_type type() const { return doc == nullptr ? value_type::invalid : node().type; }
+      explicit operator bool() const { return type() != value_type::invalid; }
+      bool is_null() const { return type() == value_type::null; }
+      bool is_bool() const { return type() == value_type::boolean; }
+      // integer和number都是数字，整数超出int64范围时解析成number
+      bool is_number() const { return type() == value_type::integer || type() == value_type::number; }
+      bool is_string() const { return type() == value_type::string; }
+      bool is_array() const { return type() == value_type::array; }
+      bool is_object() const { return type() == value_type::object; }
+
+      bool as_bool() const { return is_bool() && node().integer != 0; }
+      int64_t as_int64() const;
+      double as_double() const;
+      // 与deserialize<std::string>一样保留转义序列原文
+      std::string_view as_string() const;
+
+      // 数组的元素个数或对象的成员个数
+      size_t size() const { return is_array() || is_object() ? node().size : 0; }
+      Value operator[](size_t i) const;
+      Value operator[](std::string_view key) const;
+      range<false> elements() const;
+      range<true> members() const;
+    };
+
+    class Document {
+      friend class Value;
+      friend struct Member;
+      std::string_view input;
+      std::vector<tape_node> tape;
+     private:
+      bool error(std::string_view what, size_t off) {
+        YURI_ERROR << "document parse " << what << " failed at offset " << off << "\n";
+        tape.clear();
+        return false;
+      }
+      bool parse_string(size_t &off) {
+        auto begin = ++off;
+        while (true) {
+          off = find_in_blocks(input, off, [](const BlockMasks &masks) { return masks.quote | masks.backslash; });
+          if (off >= input.size() || input[off] == '"') break;
+          off += 2;
+        }
+        if (off >= input.size()) return error("string", begin - 1);
+        auto &node = tape.emplace_back();
+        node.type = value_type::string;
+        node.size = static_cast<uint32_t>(off - begin);
+        node.begin = static_cast<uint32_t>(begin);
+        off++;
+        return true;
+      }
+      bool parse_literal(size_t &off, std::string_view literal, value_type type, int64_t value) {
+        if (input.substr(off, literal.size()) != literal) return error("literal", off);
+        off += literal.size();
+        auto &node = tape.emplace_back();
+        node.type = type;
+        node.integer = value;
+        return true;
+      }
+      // 按JSON的数字语法 -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)? 找到数字的结尾，不符合时返回npos
+      // from_chars还接受inf、nan和前导零，所以要先检查
+      size_t number_end(size_t off, bool &integral) const {
+        auto digit = [&](size_t i) { return i < input.size() && static_cast<unsigned char>(input[i] - '0') < 10; };
+        auto digits = [&](size_t &i) {
+          if (!digit(i)) return false;
+          while (digit(i)) i++;
+          return true;
+        };
+        if (off < input.size() && input[off] == '-') off++;
+        if (!digit(off)) return std::string_view::npos;
+        if (input[off] == '0') {
+          if (digit(++off)) return std::string_view::npos;
+        } else {
+          digits(off);
+        }
+        integral = true;
+        if (off < input.size() && input[off] == '.') {
+          integral = false;
+          if (!digits(++off)) return std::string_view::npos;
+        }
+        if (off < input.size() && (input[off] == 'e' || input[off] == 'E')) {
+          integral = false;
+          if (++off < input.size() && (input[off] == '+' || input[off] == '-')) off++;
+          if (!digits(off)) return std::string_view::npos;
+        }
+        return off;
+      }
+      // 没有小数点和指数的数字先按int64解析，溢出时再按double解析
+      bool parse_numeric(size_t &off) {
+        auto begin = off;
+        bool integral;
+        auto end = number_end(off, integral);
+        if (end == std::string_view::npos) return error("number", begin);
+        // 只让from_chars看到检查过的部分
+        auto number = input.substr(0, end);
+        auto &node = tape.emplace_back();
+        node.type = value_type::integer;
+        if (integral && parse_number(number, off, node.integer)) return true;
+        off = begin;
+        node.type = value_type::number;
+        if (!parse_number(number, off, node.number)) return error("number", begin);
+        return true;
+      }
+      bool parse_value(size_t &off) {
+        if (!parse_space(input, off)) return error("value", off);
+        switch (input[off]) {
+          case '{':
+          case '[': {
+            bool object = input[off++] == '{';
+            char close = object ? '}' : ']';
+            auto index = static_cast<uint32_t>(tape.size());
+            tape.emplace_back().type = object ? value_type::object : value_type::array;
+            uint32_t count = 0;
+            if (!parse_ch(close, input, off)) {
+              while (true) {
+                if (object) {
+                  if (!parse_space(input, off) || input[off] != '"') return error("key", off);
+                  if (!parse_string(off)) return false;
+                  if (!parse_ch(':', input, off)) return error(":", off);
+                }
+                if (!parse_value(off)) return false;
+                count++;
+                if (!parse_ch(',', input, off)) break;
+              }
+              if (!parse_ch(close, input, off)) return error(std::string(1, close), off);
+            }
+            // emplace_back可能使引用失效，最后再按下标回填
+            tape[index].size = count;
+            tape[index].end = static_cast<uint32_t>(tape.size());
+            return true;
+          }
+          case '"':return parse_string(off);
+          case 't':return parse_literal(off, "true", value_type::boolean, 1);
+          case 'f':return parse_literal(off, "false", value_type::boolean, 0);
+          case 'n':return parse_literal(off, "null", value_type::null, 0);
+          default:return parse_numeric(off);
+        }
+      }
+     public:
+      Document() = default;
+      // 文档引用str中的字符串，str需要比文档活得久
+      explicit Document(std::string_view str) { parse(str); }
+
+      // 解析失败时返回false，root()为invalid；重复使用同一个文档时tape的容量会保留
+      bool parse(std::string_view str) {
+        block_scope scope;
+        tape.clear();
+        input = str;
+        if (str.size() > std::numeric_limits<uint32_t>::max()) return error("size", 0);
+        size_t off = 0;
+        if (!parse_value(off)) return false;
+        // 值之后只允许有空白
+        if (parse_space(input, off)) return error("trailing characters", off);
+        return true;
+      }
+
+      Value root() const { return tape.empty() ? Value() : Value(this, 0); }
+      size_t node_count() const { return tape.size(); }
+    };
+
+    inline const tape_node &Value::node() const { return doc->tape[index]; }
+
+    inline uint32_t Value::next() const {
+      auto &n = node();
+      return n.type == value_type::array || n.type == value_type::object ? n.end : index + 1;
+    }
+
+    inline int64_t Value::as_int64() const {
+      switch (type()) {
+        case value_type::integer:return node().integer;
+        case value_type::number: {
+          // 超出int64范围的double直接转换是未定义行为，截断到范围内，NaN返回0
+          auto number = node().number;
+          if (number != number) return 0;
+          if (number >= static_cast<double>(std::numeric_limits<int64_t>::max())) {
+            return std::numeric_limits<int64_t>::max();
+          }
+          if (number < static_cast<double>(std::numeric_limits<int64_t>::min())) {
+            return std::numeric_limits<int64_t>::min();
+          }
+          return static_cast<int64_t>(number);
+        }
+        default:return 0;
+      }
+    }
+
+    inline double Value::as_double() const {
+      switch (type()) {
+        case value_type::integer:return static_cast<double>(node().integer);
+        case value_type::number:return node().number;
+        default:return 0;
+      }
+    }
+
+    inline std::string_view Value::as_string() const {
+      if (!is_string()) return {};
+      return doc->input.substr(node().begin, node().size);
+    }
+
+    inline Value Member::value() const { return Value(doc, index + 1); }
+
+    template<bool Object>
+    inline typename Value::iterator<Object>::value_type Value::iterator<Object>::operator*() const {
+      if constexpr (Object) {
+        return Member{Value(doc, index).as_string(), doc, index};
+      } else {
+        return Value(doc, index);
+      }
+    }
+
+    template<bool Object>
+    inline Value::iterator<Object> &Value::iterator<Object>::operator++() {
+      // 对象的成员先跳过key，再跳过value
+      if constexpr (Object) index++;
+      index = Value(doc, index).next();
+      return *this;
+    }
+
+    inline Value::range<false> Value::elements() const {
+      if (!is_array()) return {{doc, 0}, {doc, 0}};
+      return {{doc, index + 1}, {doc, node().end}};
+    }
+
+    inline Value::range<true> Value::members() const {
+      if (!is_object()) return {{doc, 0}, {doc, 0}};
+      return {{doc, index + 1}, {doc, node().end}};
+    }
+
+    inline Value Value::operator[](size_t i) const {
+      if (i >= size() || !is_array()) return {};
+      auto it = elements().begin();
+      while (i-- != 0) ++it;
+      return *it;
+    }
+
+    // 线性查找，重复的key返回第一个
+    inline Value Value::operator[](std::string_view key) const {
+      for (auto member : members()) {
+        if (member.key == key) return member.value();
+      }
+      return {};
+    }
+
+    // 解析成Document，失败时返回的文档root()为invalid
+    inline Document reflect_deserialize_document(std::string_view str) {
+      return Document(str);
+    }
+
+    inline Document reflect_deserialize_document(const char *data, size_t size) {
+      return Document(std::string_view(data, size));
+    }
+  }
+  using Document = json::Document;
+}
+
+
+namespace reflect {
+  namespace json {
+    /*
+     * 按路径从JSON中取出少数几个值，不构造整个文档
+     * 路径用'/'分隔，对象用key，数组用下标，例如"root/left/data"、"items/0/id"
+     * 与路径无关的子树用skip_value跳过，只检查括号配对
+     */
+
+    class path_walker {
+      std::string_view str;
+      const std::string_view *paths;
+      // 每条路径已经匹配的长度
+      size_t *matched;
+      std::string_view *values;
+      uint64_t found = 0;
+      size_t remaining;
+     private:
+      bool error(std::string_view what, size_t off) {
+        YURI_ERROR << "path walk " << what << " failed at offset " << off << "\n";
+        return false;
+      }
+      // 路径i还没匹配的下一段
+      std::string_view segment(size_t i) const {
+        auto rest = paths[i].substr(matched[i]);
+        return rest.substr(0, rest.find('/'));
+      }
+      bool is_target(size_t i) const { return matched[i] >= paths[i].size(); }
+      template<typename F>
+      static void for_each_bit(uint64_t mask, F &&f) {
+        while (mask != 0) {
+          f(static_cast<size_t>(__builtin_ctzll(mask)));
+          mask &= mask - 1;
+        }
+      }
+      // 下一段匹配的路径进入子节点，返回false表示语法错误
+      bool walk_child(size_t &off, uint64_t child) {
+        if (child == 0) {
+          if (!skip_value(str, off)) return error("value", off);
+          return true;
+        }
+        size_t saved[64];
+        for_each_bit(child, [&](size_t i) {
+          saved[i] = matched[i];
+          matched[i] += segment(i).size() + 1;
+        });
+        bool ok = walk_value(off, child);
+        for_each_bit(child, [&](size_t i) { matched[i] = saved[i]; });
+        return ok;
+      }
+      bool walk_object(size_t &off, uint64_t mask) {
+        off++;
+        if (parse_space(str, off) && str[off] == '}') {
+          off++;
+          return true;
+        }
+        while (true) {
+          if (!parse_space(str, off) || str[off] != '"') return error("key", off);
+          auto begin = off + 1;
+          if (!skip_string(str, off)) return error("key", off);
+          auto key = str.substr(begin, off - 1 - begin);
+          if (!parse_space(str, off) || str[off] != ':') return error(":", off);
+          off++;
+          uint64_t child = 0;
+          for_each_bit(mask & ~found, [&](size_t i) {
+            if (segment(i) == key) child |= uint64_t(1) << i;
+          });
+          if (!walk_child(off, child)) return false;
+          if (remaining == 0) return true;
+          if (!parse_space(str, off)) return error("}", off);
+          if (str[off] == ',') {
+            off++;
+          } else if (str[off] == '}') {
+            off++;
+            return true;
+          } else {
+            return error("}", off);
+          }
+        }
+      }
+      bool walk_array(size_t &off, uint64_t mask) {
+        off++;
+        if (parse_space(str, off) && str[off] == ']') {
+          off++;
+          return true;
+        }
+        for (size_t index = 0;; index++) {
+          uint64_t child = 0;
+          for_each_bit(mask & ~found, [&](size_t i) {
+            auto seg = segment(i);
+            size_t n;
+            auto[ptr, ec] = std::from_chars(seg.data(), seg.data() + seg.size(), n);
+            if (ec == std::errc() && ptr == seg.data() + seg.size() && n == index) child |= uint64_t(1) << i;
+          });
+          if (!walk_child(off, child)) return false;
+          if (remaining == 0) return true;
+          if (!parse_space(str, off)) return error("]", off);
+          if (str[off] == ',') {
+            off++;
+          } else if (str[off] == ']') {
+            off++;
+            return true;
+          } else {
+            return error("]", off);
+          }
+        }
+      }
+      // mask中的路径都匹配到了当前值，已经匹配完的路径取当前值的原文
+      bool walk_value(size_t &off, uint64_t mask) {
+        if (!parse_space(str, off)) return error("value", off);
+        uint64_t targets = 0;
+        for_each_bit(mask, [&](size_t i) {
+          if (is_target(i)) targets |= uint64_t(1) << i;
+        });
+        auto begin = off;
+        uint64_t descend = mask & ~targets;
+        if (descend != 0 && str[off] == '{') {
+          if (!walk_object(off, descend)) return false;
+        } else if (descend != 0 && str[off] == '[') {
+          if (!walk_array(off, descend)) return false;
+        } else if (!skip_value(str, off)) {
+          return error("value", off);
+        }
+        // 子节点中的路径都找到后提前返回时，off没有到达当前值的结尾，但此时targets一定为空
+        for_each_bit(targets, [&](size_t i) {
+          values[i] = str.substr(begin, off - begin);
+          remaining--;
+        });
+        found |= targets;
+        return true;
+      }
+     public:
+      path_walker(std::string_view str, const std::string_view *paths, size_t *matched,
+                  std::string_view *values, size_t count)
+          : str(str), paths(paths), matched(matched), values(values), remaining(count) {}
+      bool walk() {
+        size_t off = 0;
+        uint64_t mask = remaining == 64 ? ~uint64_t(0) : (uint64_t(1) << remaining) - 1;
+        return walk_value(off, mask);
+      }
+    };
+
+    // 一次扫描取出多条路径对应的值在str中的原文，找不到的路径为空；最多64条路径
+    // 经过的部分有语法错误时返回false
+    inline bool find_paths(std::string_view str, const std::string_view *paths, size_t count,
+                           std::string_view *values) {
+      if (count > 64) {
+        YURI_ERROR << "too many paths\n";
+        return false;
+      }
+      block_scope scope;
+      size_t matched[64] = {};
+      for (size_t i = 0; i < count; i++) values[i] = {};
+      if (count == 0) return true;
+      return path_walker(str, paths, matched, values, count).walk();
+    }
+
+    // 取出一条路径对应的值的原文，找不到时返回空
+    inline std::string_view find_path(std::string_view str, std::string_view path) {
+      std::string_view value;
+      find_paths(str, &path, 1, &value);
+      return value;
+    }
+
+    // 取出一条路径对应的值并反序列化成T，找不到或解析失败时返回false
+    template<typename T>
+    inline bool extract(std::string_view str, std::string_view path, T &t) {
+      auto value = find_path(str, path);
+      size_t off = 0;
+      return !value.empty() && deserialize<T>(value, off, &t);
+    }
+  }
+}
+
+
+namespace reflect {
+  namespace json {
+    /*
+     * 推送式解析，输入可以分成任意多段依次传入，每段解析完即可丢弃
+     */
+
+    enum class push_token { string, number, literal };
+
+    struct push_type;
+    // 下一个值的类型和写入地址
+    struct push_slot {
+      const push_type *type;
+      void *target;
+      // 延迟解析的字段的type_id
+      TypeID id = nullptr;
+    };
+    // 正在解析的对象或数组
+    struct push_frame {
+      push_slot slot;
+      // 数组元素的临时对象
+      void *scratch;
+      bool object;
+    };
+
+    // 每种类型一张函数表，不支持的操作为nullptr
+    struct push_type {
+      // 字符串、数字、true/false/null
+      bool (*scalar)(void *target, push_token kind, std::string_view text) = nullptr;
+      // 对象或数组开始，open是'{'或'['
+      bool (*begin)(push_frame &frame, char open) = nullptr;
+      // 对象中的key，确定下一个值的类型和地址
+      bool (*key)(push_frame &frame, std::string_view key, push_slot &child) = nullptr;
+      // 数组的下一个元素
+      void (*element)(push_frame &frame, push_slot &child) = nullptr;
+      // 数组元素解析完成
+      void (*element_done)(push_frame &frame) = nullptr;
+      // 容器结束或解析中止时释放frame持有的资源
+      void (*end)(push_frame &frame) = nullptr;
+      // 智能指针：null时置空并返回nullptr，否则创建对象并返回其地址
+      void *(*deref)(void *target, bool null) = nullptr;
+      const push_type *pointee = nullptr;
+    };
+
+    template<typename T>
+    inline const push_type *push_type_of();
+
+    // 管理type_id到push_type的映射，用于查找reflect类型中字段的类型
+    // 每种类型在push_type_of第一次用到时登记，不需要流式解析的类型不占用这张表
+    inline handler_table<const push_type *> &push_handler() {
+      static handler_table<const push_type *> handler;
+      return handler;
+    }
+
+    // 未知字段的值，只检查语法，不保存
+    inline const push_type *push_skip_type() {
+      static const push_type type = [] {
+        push_type t;
+        t.scalar = [](void *, push_token, std::string_view) { return true; };
+        t.begin = [](push_frame &, char) { return true; };
+        t.key = [](push_frame &, std::string_view, push_slot &child) {
+          child = {push_skip_type(), nullptr};
+          return true;
+        };
+        t.element = [](push_frame &, push_slot &child) { child = {push_skip_type(), nullptr}; };
+        return t;
+      }();
+      return &type;
+    }
+
+    // push_handler中找不到的字段类型，先缓存该值的原文，值结束后交给Deserializer整体解析
+    inline const push_type *push_deferred_type() {
+      static const push_type type;
+      return &type;
+    }
+
+    // 数组元素的临时对象类型；map的value_type是pair<const K,V>，先解析到pair<K,V>中，插入时再移入
+    template<typename V>
+    struct push_element {
+      using type = V;
+    };
+    template<typename K, typename V>
+    struct push_element<std::pair<const K, V>> {
+      using type = std::pair<K, V>;
+    };
+
+    template<typename D>
+    using has_mapped_type_t = typename D::mapped_type;
+
+    template<typename T>
+    inline push_type make_push_type() {
+      push_type t;
+      // bool类型
+      if constexpr (std::is_same_v<T, bool>) {
+        t.scalar = [](void *target, push_token kind, std::string_view text) {
+          if (kind != push_token::literal || (text != "true" && text != "false")) return false;
+          *static_cast<T *>(target) = text == "true";
+          return true;
+        };
+      }
+        // 数字类型
+      else if constexpr (std::is_arithmetic_v<T>) {
+        t.scalar = [](void *target, push_token kind, std::string_view text) {
+          size_t off = 0;
+          return kind == push_token::number && parse_number(text, off, *static_cast<T *>(target))
+              && off == text.size();
+        };
+      }
+        // 字符串类型，与deserialize<std::string>一样保留转义序列原文
+      else if constexpr (is_char_string_v<T>) {
+        t.scalar = [](void *target, push_token kind, std::string_view text) {
+          if (kind != push_token::string) return false;
+          adopt_resource(*static_cast<T *>(target));
+          static_cast<T *>(target)->assign(text);
+          return true;
+        };
+      }
+        // 可迭代类型，元素先解析到临时对象再插入
+      else if constexpr (std::experimental::is_detected_v<reflect::has_begin_t, T>
+          && std::experimental::is_detected_v<reflect::has_end_t, T>) {
+        using value_type = typename push_element<typename T::value_type>::type;
+        t.begin = [](push_frame &frame, char open) {
+          if (open != '[') return false;
+          adopt_resource(*static_cast<T *>(frame.slot.target));
+          static_cast<T *>(frame.slot.target)->clear();
+          frame.scratch = new value_type();
+          return true;
+        };
+        t.element = [](push_frame &frame, push_slot &child) {
+          child = {push_type_of<value_type>(), frame.scratch};
+        };
+        t.element_done = [](push_frame &frame) {
+          auto &vec = *static_cast<T *>(frame.slot.target);
+          auto &value = *static_cast<value_type *>(frame.scratch);
+          if constexpr (std::experimental::is_detected_v<has_mapped_type_t, T>) {
+            vec.emplace_hint(vec.end(), std::move(value.first), std::move(value.second));
+          } else {
+            vec.insert(vec.end(), std::move(value));
+          }
+          value = value_type();
+        };
+        t.end = [](push_frame &frame) {
+          delete static_cast<value_type *>(frame.scratch);
+          frame.scratch = nullptr;
+        };
+      }
+        // pair类型，格式与deserialize相同：{"first":...,"second":...}
+      else if constexpr (std::experimental::is_detected_v<reflect::has_first_t, T>
+          && std::experimental::is_detected_v<reflect::has_second_t, T>) {
+        using first_type = typename T::first_type;
+        using second_type = typename T::second_type;
+        static_assert(!std::is_const_v<first_type>, "key of a map element is parsed through push_element");
+        t.begin = [](push_frame &, char open) { return open == '{'; };
+        t.key = [](push_frame &frame, std::string_view key, push_slot &child) {
+          auto &p = *static_cast<T *>(frame.slot.target);
+          if (key == "first") {
+            child = {push_type_of<first_type>(), &p.first};
+          } else if (key == "second") {
+            child = {push_type_of<second_type>(), &p.second};
+          } else {
+            return false;
+          }
+          return true;
+        };
+      }
+        // reflect类型，字段的类型由type_id在push_handler中查找，未知字段跳过
+      else if constexpr (std::experimental::is_detected_v<reflect::has_get_field_info_t, T>) {
+        t.begin = [](push_frame &, char open) { return open == '{'; };
+        t.key = [](push_frame &frame, std::string_view key, push_slot &child) {
+          if (auto id = T::get_type_id_by_name(key); id == nullptr) {
+            child = {push_skip_type(), nullptr};
+          } else if (auto type = push_handler().find(id); type != nullptr) {
+            child = {type, static_cast<char *>(frame.slot.target) + T::get_offset_by_name(key)};
+          } else {
+            child = {push_deferred_type(), static_cast<char *>(frame.slot.target) + T::get_offset_by_name(key), id};
+          }
+          return true;
+        };
+      }
+        // 智能指针类型
+      else if constexpr(is_shared_ptr_v<T>) {
+        using element_type = typename T::element_type;
+        t.deref = [](void *target, bool null) -> void * {
+          auto &p = *static_cast<T *>(target);
+          if (null) {
+            p = nullptr;
+            return nullptr;
+          }
+          p = make_shared_object<element_type>();
+          return p.get();
+        };
+        t.pointee = push_type_of<element_type>();
+      } else {
+        static_assert(std::experimental::is_detected_v<reflect::has_get_field_info_t, T>, "can not parse");
+      }
+      return t;
+    }
+
+    template<typename T>
+    inline const push_type *push_type_of() {
+      static const push_type type = make_push_type<T>();
+      static const bool registered = (push_handler().insert(type_id<T>, &type), true);
+      (void) registered;
+      return &type;
+    }
+
+    class PushParser {
+      enum class expect { value, value_or_end, key, key_or_end, colon, comma_or_end, done };
+      enum class lex { none, string, scalar };
+     public:
+      // 提前登记T类型的push_type；reflect类型中没有登记过的字段类型会先缓存整个值再解析
+      template<typename T>
+      inline static void register_handler() { push_type_of<T>(); }
+     private:
+      std::vector<push_frame> frames;
+      push_slot pending{};
+      expect state = expect::value;
+      lex token = lex::none;
+      // 跨越了段边界的token
+      std::string partial;
+      // 字符串中上一段以反斜杠结尾
+      bool escaped = false;
+      bool failed = false;
+      // 已经处理过的字节数，用于报错
+      size_t consumed = 0;
+      // 当前这一段输入
+      std::string_view input;
+      // 正在缓存原文的延迟解析字段，depth是该字段所在对象的frames层数
+      struct deferred_value {
+        TypeID id = nullptr;
+        void *target = nullptr;
+        size_t depth = 0;
+        // 之前各段中的原文
+        std::string text;
+        // 本段中原文的起点
+        size_t begin = 0;
+        bool active = false;
+      } deferred;
+     private:
+      bool error(std::string_view what, size_t pos) {
+        YURI_ERROR << "push parse " << what << " failed at offset " << consumed + pos << "\n";
+        failed = true;
+        return false;
+      }
+      static bool is_scalar_char(char c) {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+            || c == '-' || c == '+' || c == '.';
+      }
+      void release() {
+        for (auto &frame : frames) {
+          if (frame.slot.type->end != nullptr) frame.slot.type->end(frame);
+        }
+        frames.clear();
+      }
+      // 延迟解析的字段值到end为止，end之前可能多出一个分隔符，不影响解析
+      bool finish_deferred(size_t end) {
+        deferred.active = false;
+        end = std::min(end, input.size());
+        deferred.text.append(input.data() + deferred.begin, end - deferred.begin);
+        // deferred.text在各个字段之间复用，不能沿用feed中的分类缓存
+        isolated_block_scope scope;
+        size_t off = 0;
+        if (!Deserializer::parse(deferred.id, deferred.text, off, deferred.target)) return error("value", end);
+        return true;
+      }
+      // 一个值解析完成，end是该值在本段输入中的结尾之后的位置
+      bool value_done(size_t end) {
+        if (deferred.active && frames.size() == deferred.depth && !finish_deferred(end)) return false;
+        if (frames.empty()) {
+          state = expect::done;
+          return true;
+        }
+        auto &top = frames.back();
+        if (!top.object && top.slot.type->element_done != nullptr) top.slot.type->element_done(top);
+        state = expect::comma_or_end;
+        return true;
+      }
+      // 取出下一个值的位置，数组中的第一个元素在这里才确定
+      push_slot take_pending() {
+        if (state == expect::value_or_end) {
+          auto &top = frames.back();
+          top.slot.type->element(top, pending);
+        }
+        return pending;
+      }
+      // 解引用智能指针，返回false表示值已经是null
+      static bool resolve(push_slot &slot, bool null) {
+        while (slot.type->deref != nullptr) {
+          slot.target = slot.type->deref(slot.target, null);
+          if (null) return false;
+          slot.type = slot.type->pointee;
+        }
+        return true;
+      }
+      bool on_scalar(push_token kind, std::string_view text, size_t pos) {
+        if (state == expect::key || state == expect::key_or_end) {
+          if (kind != push_token::string) return error("key", pos);
+          auto &top = frames.back();
+          if (!top.slot.type->key(top, text, pending)) return error("key " + std::string(text), pos);
+          state = expect::colon;
+          return true;
+        }
+        if (state != expect::value && state != expect::value_or_end) return error("value", pos);
+        auto slot = take_pending();
+        if (resolve(slot, kind == push_token::literal && text == "null")) {
+          if (slot.type->scalar == nullptr || !slot.type->scalar(slot.target, kind, text)) {
+            return error("value " + std::string(text), pos);
+          }
+        }
+        // 字符串的pos是结尾的引号，数字和字面量的pos是其后的分隔符
+        return value_done(pos + 1);
+      }
+      bool on_structural(char c, size_t pos) {
+        switch (c) {
+          case '{':
+          case '[': {
+            if (state != expect::value && state != expect::value_or_end) return error(std::string(1, c), pos);
+            auto slot = take_pending();
+            resolve(slot, false);
+            frames.push_back(push_frame{slot, nullptr, c == '{'});
+            if (slot.type->begin == nullptr || !slot.type->begin(frames.back(), c)) {
+              return error(std::string(1, c), pos);
+            }
+            state = c == '{' ? expect::key_or_end : expect::value_or_end;
+            return true;
+          }
+          case '}':
+          case ']': {
+            bool object = c == '}';
+            if (frames.empty() || frames.back().object != object
+                || (state != expect::comma_or_end && state != (object ? expect::key_or_end : expect::value_or_end))) {
+              return error(std::string(1, c), pos);
+            }
+            auto &top = frames.back();
+            if (top.slot.type->end != nullptr) top.slot.type->end(top);
+            frames.pop_back();
+            return value_done(pos + 1);
+          }
+          case ':': {
+            if (state != expect::colon) return error(":", pos);
+            if (pending.type == push_deferred_type()) {
+              // 值本身只检查语法，原文从冒号之后开始缓存
+              deferred.id = pending.id;
+              deferred.target = pending.target;
+              deferred.depth = frames.size();
+              deferred.text.clear();
+              deferred.begin = pos + 1;
+              deferred.active = true;
+              pending = {push_skip_type(), nullptr};
+            }
+            state = expect::value;
+            return true;
+          }
+          case ',': {
+            if (state != expect::comma_or_end) return error(",", pos);
+            auto &top = frames.back();
+            if (top.object) {
+              state = expect::key;
+            } else {
+              top.slot.type->element(top, pending);
+              state = expect::value;
+            }
+            return true;
+          }
+          default:return error(std::string(1, c), pos);
+        }
+      }
+      // 一个字符串、数字或字面量结束，text可能指向partial
+      bool finish_token(push_token kind, std::string_view text, size_t pos) {
+        token = lex::none;
+        bool ok = on_scalar(kind, text, pos);
+        partial.clear();
+        return ok;
+      }
+     public:
+      // 没有登记过push_type的类型，整个输入缓存下来，finish时交给Deserializer解析
+      PushParser(TypeID id, void *target) {
+        if (auto type = push_handler().find(id); type != nullptr) {
+          pending = {type, target};
+        } else if (Deserializer::handler().find(id) != nullptr) {
+          pending = {push_skip_type(), nullptr};
+          deferred.id = id;
+          deferred.target = target;
+          deferred.active = true;
+        } else {
+          YURI_ERROR << "no such handler\n";
+          failed = true;
+        }
+      }
+      template<typename T>
+      explicit PushParser(T &target) : pending{push_type_of<T>(), &target} {}
+      PushParser(const PushParser &) = delete;
+      PushParser &operator=(const PushParser &) = delete;
+      ~PushParser() { release(); }
+
+      // 传入下一段输入，出错时返回false，之后的输入都会被忽略
+      bool feed(std::string_view data) {
+        if (failed) return false;
+        // 各段输入可能复用同一块缓冲区，缓存只在一次feed中有效
+        block_scope scope;
+        input = data;
+        size_t i = 0;
+        while (i < data.size()) {
+          if (token == lex::string) {
+            size_t begin = i;
+            if (escaped) {
+              escaped = false;
+              i++;
+            }
+            while (true) {
+              i = find_in_blocks(data, i, [](const BlockMasks &masks) { return masks.quote | masks.backslash; });
+              if (i >= data.size() || data[i] == '"') break;
+              if (i + 1 == data.size()) {
+                escaped = true;
+                i = data.size();
+                break;
+              }
+              i += 2;
+            }
+            if (i >= data.size()) {
+              partial.append(data.data() + begin, data.size() - begin);
+              break;
+            }
+            std::string_view text(data.data() + begin, i - begin);
+            if (!partial.empty()) text = partial.append(text);
+            if (!finish_token(push_token::string, text, i++)) return false;
+          } else if (token == lex::scalar) {
+            size_t begin = i;
+            while (i < data.size() && is_scalar_char(data[i])) i++;
+            std::string_view text(data.data() + begin, i - begin);
+            if (i == data.size()) {
+              partial.append(text);
+              break;
+            }
+            if (!partial.empty()) text = partial.append(text);
+            auto kind = text[0] == '-' || (text[0] >= '0' && text[0] <= '9') ? push_token::number : push_token::literal;
+            if (!finish_token(kind, text, i)) return false;
+          } else {
+            char c = data[i];
+            if (isspace(c)) {
+              i++;
+            } else if (c == '"') {
+              token = lex::string;
+              i++;
+            } else if (is_scalar_char(c)) {
+              token = lex::scalar;
+            } else if (!on_structural(c, i++)) {
+              return false;
+            }
+          }
+        }
+        if (deferred.active) {
+          deferred.text.append(data.data() + deferred.begin, data.size() - deferred.begin);
+          deferred.begin = 0;
+        }
+        consumed += data.size();
+        return true;
+      }
+
+      // 输入结束，返回是否得到了一个完整的值
+      bool finish() {
+        if (failed) return false;
+        // 最后一段输入已经缓存进deferred.text
+        input = {};
+        if (token == lex::scalar) {
+          std::string text = std::move(partial);
+          auto kind = text[0] == '-' || (text[0] >= '0' && text[0] <= '9') ? push_token::number : push_token::literal;
+          if (!finish_token(kind, text, 0)) return false;
+        }
+        if (token == lex::string || state != expect::done) return error("incomplete input", 0);
+        return true;
+      }
+
+      bool done() const { return !failed && token == lex::none && state == expect::done; }
+    };
+  }
+  using PushParser = json::PushParser;
+}
+
+#include <cerrno>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace reflect {
+  /*
+   * 只读映射一个文件，直接在映射的内存上反序列化，不需要先读进std::string
+   */
+  class MappedFile {
+    const char *_data = nullptr;
+    size_t _size = 0;
+   public:
+    // 打开或映射失败时抛出std::system_error
+    explicit MappedFile(const char *path) {
+      int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+      if (fd < 0) throw std::system_error(errno, std::generic_category(), path);
+      struct stat st{};
+      if (::fstat(fd, &st) != 0) {
+        int err = errno;
+        ::close(fd);
+        throw std::system_error(err, std::generic_category(), path);
+      }
+      _size = static_cast<size_t>(st.st_size);
+      // 长度为0的文件不能mmap
+      if (_size != 0) {
+        void *addr = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+          int err = errno;
+          ::close(fd);
+          throw std::system_error(err, std::generic_category(), path);
+        }
+        ::madvise(addr, _size, MADV_SEQUENTIAL);
+        _data = static_cast<const char *>(addr);
+      }
+      ::close(fd);
+    }
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&other) noexcept : _data(other._data), _size(other._size) {
+      other._data = nullptr;
+      other._size = 0;
+    }
+    ~MappedFile() {
+      if (_data != nullptr) ::munmap(const_cast<char *>(_data), _size);
+    }
+    const char *data() const { return _data; }
+    size_t size() const { return _size; }
+    std::string_view view() const { return std::string_view(_data, _size); }
+  };
+
+  namespace json {
+    // 从文件反序列化一个T，文件只在解析期间被映射
+    template<typename T>
+    inline static T reflect_deserialize_file(const char *path) {
+      MappedFile file(path);
+      return reflect_default_deserialize<T>(file.view());
+    }
+  }
+}
+
 #endif
@@ -0,0 +1,68 @@
+/**
+  * @file   BatchSerializer.h
+  * @author sora
+  * @date   2026/10/18
+  */
+
+#ifndef LIBYURI_SRC_V2_BATCHSERIALIZER_H_
+#define LIBYURI_SRC_V2_BATCHSERIALIZER_H_
+#include <string_view>
+#include "JsonSerializer.h"
+
+namespace yuri {
+  enum class BatchFormat {
+    // 每条记录一行（NDJSON）
+    Lines,
+    // 所有记录组成一个JSON数组
+    Array
+  };
+
+  // 暴露Output的缓冲区，多批之间复用
+  template<typename Output>
+  class BatchOutput : public Output {
+   public:
+    OutputBuffer &getBuffer() { return this->buffer; }
+    const OutputBuffer &getBuffer() const { return this->buffer; }
+  };
+
+  // 把一组记录序列化到同一个缓冲区，缓冲区的容量在批之间保留
+  template<typename Output = JsonOutput>
+  class BatchSerializer {
+    BatchOutput<Output> output;
+    BatchFormat format;
+   public:
+    explicit BatchSerializer(BatchFormat format = BatchFormat::Lines) : format(format) {}
+
+    void reserve(size_t n) {
+      output.reserve(n);
+    }
+
+    // 返回的视图在下一次调用serialize之前有效
+    template<typename Range>
+    std::string_view serialize(const Range &records) {
+      auto &buffer = output.getBuffer();
+      buffer.clear();
+      if (format == BatchFormat::Array) {
+        buffer.put('[');
+        bool first = true;
+        for (auto &&record : records) {
+          buffer.separate(first);
+          output.output(record);
+        }
+        buffer.put(']');
+      } else {
+        for (auto &&record : records) {
+          output.output(record);
+          buffer.put('\n');
+        }
+      }
+      return buffer.view();
+    }
+
+    std::string_view view() const {
+      return output.getBuffer().view();
+    }
+  };
+}
+
+#endif //LIBYURI_SRC_V2_BATCHSERIALIZER_H_
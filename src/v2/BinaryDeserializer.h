@@ -0,0 +1,204 @@
+/**
+  * @file   BinaryDeserializer.h
+  * @author sora
+  * @date   2026/10/18
+  */
+
+#ifndef LIBYURI_SRC_V2_BINARYDESERIALIZER_H_
+#define LIBYURI_SRC_V2_BINARYDESERIALIZER_H_
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include "Endian.h"
+#include "Deserializer.h"
+#include "TypeTraits/RangeTrait.h"
+#include "TypeTraits/InsertTrait.h"
+#include "TypeTraits/ContiguousTrait.h"
+#include "DeserializeFunction.h"
+
+namespace yuri {
+
+  template<typename T>
+  class Reflectable;
+
+  template<typename T>
+  using reserve_t = decltype(std::declval<T &>().reserve(size_t()));
+
+  // BinaryOutput的逆过程，格式说明见BinarySerializer.h
+  class BinaryInput : public InputBase<BinaryInput> {
+    const char *begin = nullptr;
+    const char *cur = nullptr;
+    const char *end = nullptr;
+   private:
+    template<typename T>
+    static constexpr bool inputable = std::experimental::is_detected_v<input_t, BinaryInput, T>;
+
+    [[noreturn]] void error(const std::string &what) const {
+      throw std::runtime_error("binary decode error: " + what + " at offset " + std::to_string(cur - begin));
+    }
+
+    void need(size_t n) {
+      if (static_cast<size_t>(end - cur) < n) error("unexpected end of input");
+    }
+
+    u64 varintInput() {
+      u64 value = 0;
+      for (u32 shift = 0; shift < 64; shift += 7) {
+        need(1);
+        auto byte = static_cast<u8>(*cur++);
+        value |= static_cast<u64>(byte & 0x7Fu) << shift;
+        if ((byte & 0x80u) == 0) return value;
+      }
+      error("varint too long");
+    }
+
+    // 长度前缀不可能超过剩余字节数，用于提前拒绝损坏的输入
+    size_t lengthInput() {
+      auto length = varintInput();
+      if (length > static_cast<u64>(end - cur)) error("length out of range");
+      return static_cast<size_t>(length);
+    }
+
+    bool presenceInput() {
+      need(1);
+      return *cur++ != 0;
+    }
+
+    template<typename T>
+    void blockInput(T &list) {
+      using V = typename T::value_type;
+      auto count = varintInput();
+      need(1);
+      bool swap = (*cur++ != 0) == isLittleEndian;
+      if (count > static_cast<u64>(end - cur) / sizeof(V)) error("length out of range");
+      if constexpr (std::experimental::is_detected_v<reserve_t, T>) {
+        list.resize(count);
+      } else if (count != list.size()) {
+        error("array size mismatch");
+      }
+      // 空数组的data()可能是空指针，不能传给memcpy
+      if (count == 0) return;
+      std::memcpy(list.data(), cur, count * sizeof(V));
+      cur += count * sizeof(V);
+      if (swap) {
+        using U = typename UnsignedOfSize<sizeof(V)>::type;
+        for (auto &value : list) {
+          U bits;
+          std::memcpy(&bits, &value, sizeof(V));
+          bits = byteSwap(bits);
+          std::memcpy(&value, &bits, sizeof(V));
+        }
+      }
+    }
+
+    template<typename T, typename Create>
+    void pointerInput(T &ptr, Create create) {
+      if (!presenceInput()) {
+        ptr = nullptr;
+        return;
+      }
+      if (ptr == nullptr) ptr = create();
+      input(*ptr);
+    }
+   public:
+    void reset(std::string_view str) {
+      begin = cur = str.data();
+      end = begin + str.size();
+    }
+
+    void finish() {
+      if (cur != end) error("trailing bytes");
+    }
+
+    void input(bool &b) {
+      b = presenceInput();
+    }
+
+    template<typename T, typename Enable = std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>>>
+    void input(T &number) {
+      if constexpr (std::is_enum_v<T>) {
+        std::underlying_type_t<T> value;
+        input(value);
+        number = static_cast<T>(value);
+      } else if constexpr (std::is_floating_point_v<T>) {
+        need(sizeof(T));
+        number = loadLittleEndian<T>(cur);
+        cur += sizeof(T);
+      } else if constexpr (std::is_signed_v<T>) {
+        auto raw = varintInput();
+        auto value = static_cast<i64>(raw >> 1u) ^ -static_cast<i64>(raw & 1u);
+        if (value < std::numeric_limits<T>::min() || value > std::numeric_limits<T>::max()) {
+          error("integer out of range");
+        }
+        number = static_cast<T>(value);
+      } else {
+        auto value = varintInput();
+        if (value > std::numeric_limits<T>::max()) error("integer out of range");
+        number = static_cast<T>(value);
+      }
+    }
+
+    void input(std::string &str) {
+      auto length = lengthInput();
+      str.assign(cur, length);
+      cur += length;
+    }
+
+    template<typename T, typename Enable = std::enable_if_t<inputable<T>>>
+    void input(T *&ptr) {
+      pointerInput(ptr, []() { return new T(); });
+    }
+
+    template<typename T, typename Enable = std::enable_if_t<inputable<T>>>
+    void input(std::shared_ptr<T> &ptr) {
+      pointerInput(ptr, []() { return std::make_shared<T>(); });
+    }
+
+    template<typename T, typename Enable = std::enable_if_t<inputable<T>>>
+    void input(std::unique_ptr<T> &ptr) {
+      pointerInput(ptr, []() { return std::make_unique<T>(); });
+    }
+
+    template<typename K, typename V, typename Enable = std::enable_if_t<inputable<K> && inputable<V>>>
+    void input(std::pair<K, V> &pair) {
+      input(pair.first);
+      input(pair.second);
+    }
+
+    template<typename T, typename Enable = std::enable_if_t<is_contiguous_arithmetic_v<T> || (is_range_v<T>
+        && is_insertable_v<T>
+        && inputable<mutable_value_t<typename T::value_type>>)>, typename _Place = void>
+    void input(T &list) {
+      if constexpr (is_contiguous_arithmetic_v<T>) {
+        blockInput(list);
+      } else {
+        // 每个元素至少占一个字节
+        auto count = lengthInput();
+        list.clear();
+        if constexpr (std::experimental::is_detected_v<reserve_t, T>) list.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+          mutable_value_t<typename T::value_type> value{};
+          input(value);
+          list.insert(list.end(), std::move(value));
+        }
+      }
+    }
+
+    template<typename T>
+    void input(Reflectable<T> &reflectable) {
+      auto &object = static_cast<T &>(reflectable);
+      auto count = varintInput();
+      if (count > Reflectable<T>::fieldCount()) error("too many fields");
+      size_t index = 0;
+      Reflectable<T>::forEachField([&](auto field) {
+        if (index++ < count) input(field.get(object));
+      });
+    }
+  };
+
+  using BinaryDeserializer = Deserializer<BinaryInput>;
+}
+
+#endif //LIBYURI_SRC_V2_BINARYDESERIALIZER_H_
@@ -0,0 +1,146 @@
+/**
+  * @file   BinarySerializer.h
+  * @author sora
+  * @date   2026/10/18
+  */
+
+#ifndef LIBYURI_SRC_V2_BINARYSERIALIZER_H_
+#define LIBYURI_SRC_V2_BINARYSERIALIZER_H_
+#include <iterator>
+#include <memory>
+#include "Endian.h"
+#include "Serializer.h"
+#include "TypeTraits/RangeTrait.h"
+#include "TypeTraits/ContiguousTrait.h"
+#include "TypeTraits/OutputStreamOverloadTraits.h"
+
+namespace yuri {
+
+  template<typename T>
+  class Reflectable;
+
+  // 紧凑二进制格式：
+  // 整数为varint（有符号整数先做zigzag），浮点数为小端定长，bool为一个字节
+  // 字符串和容器先写varint长度，指针先写一个字节表示是否为空
+  // 元素为算术类型的vector/array在长度后写一个字节序标记（0小端，1大端），然后整块拷贝元素
+  // Reflectable先写varint字段数，再按声明顺序写各字段，不写字段名
+  class BinaryOutput : public OutputBase<BinaryOutput, std::string> {
+   private:
+    void varintOutput(u64 value) {
+      auto ptr = buffer.claim(10);
+      size_t n = 0;
+      while (value >= 0x80) {
+        ptr[n++] = static_cast<char>(value | 0x80);
+        value >>= 7;
+      }
+      ptr[n++] = static_cast<char>(value);
+      buffer.commit(n);
+    }
+    void stringOutput(std::string_view str) {
+      varintOutput(str.size());
+      buffer.write(str);
+    }
+    template<typename T>
+    void blockOutput(const T *data, size_t count) {
+      varintOutput(count);
+      buffer.put(isLittleEndian ? 0 : 1);
+      // 空数组的data()可能是空指针
+      if (count != 0) buffer.write(reinterpret_cast<const char *>(data), count * sizeof(T));
+    }
+    template<typename T>
+    void listOutput(const T &list) {
+      if constexpr (is_contiguous_arithmetic_v<T>) {
+        blockOutput(list.data(), list.size());
+      } else {
+        varintOutput(std::distance(std::begin(list), std::end(list)));
+        for (auto &&elem : list) {
+          output(elem);
+        }
+      }
+    }
+   public:
+    void output(std::string_view str) {
+      stringOutput(str);
+    }
+
+    void output(const char *str) {
+      stringOutput(str);
+    }
+    void output(const std::string &str) {
+      stringOutput(str);
+    }
+
+    void output(bool b) {
+      buffer.put(b ? 1 : 0);
+    }
+
+    template<typename T, typename Enable = std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>>>
+    void output(T number) {
+      if constexpr (std::is_enum_v<T>) {
+        output(static_cast<std::underlying_type_t<T>>(number));
+      } else if constexpr (std::is_floating_point_v<T>) {
+        storeLittleEndian(buffer.claim(sizeof(T)), number);
+        buffer.commit(sizeof(T));
+      } else if constexpr (std::is_signed_v<T>) {
+        auto value = static_cast<i64>(number);
+        varintOutput((static_cast<u64>(value) << 1u) ^ static_cast<u64>(value >> 63));
+      } else {
+        varintOutput(number);
+      }
+    }
+
+    template<typename T>
+    void output(T *const ptr) {
+      if (ptr == nullptr) {
+        buffer.put(0);
+      } else {
+        buffer.put(1);
+        output(*ptr);
+      }
+    }
+
+    template<typename T>
+    void output(const std::shared_ptr<T> &ptr) {
+      output(ptr.get());
+    }
+
+    template<typename T>
+    void output(const std::unique_ptr<T> &ptr) {
+      output(ptr.get());
+    }
+
+    template<typename K, typename V>
+    void output(const std::pair<K, V> &pair) {
+      output(pair.first);
+      output(pair.second);
+    }
+
+    template<typename T, typename Enable = std::enable_if_t<is_range_v<T>>>
+    void output(const T &list) {
+      listOutput(list);
+    }
+
+    template<typename T>
+    void output(const Reflectable<T> &reflectable) {
+      const auto &object = static_cast<const T &>(reflectable);
+      varintOutput(Reflectable<T>::fieldCount());
+      Reflectable<T>::forEachField([&](auto field) {
+        output(field.get(object));
+      });
+    }
+
+    template<typename T, typename Enable = std::enable_if_t<is_outputstream_overload<T>
+        && !std::is_arithmetic_v<T> && !std::is_enum_v<T>>, typename _Place = void>
+    void output(const T &object) {
+      stringOutput(streamString(object));
+    }
+
+    std::string toResult() {
+      return buffer.release();
+    }
+  };
+
+  using BinarySerializer = Serializer<BinaryOutput>;
+}
+
+#endif //LIBYURI_SRC_V2_BINARYSERIALIZER_H_
@@ -0,0 +1,34 @@
+/**
+  * @file   DeserializeFunction.h
+  * @author sora
+  * @date   2026/10/18
+  */
+
+#ifndef LIBYURI_SRC_V2_DESERIALIZEFUNCTION_H_
+#define LIBYURI_SRC_V2_DESERIALIZEFUNCTION_H_
+#include <experimental/type_traits>
+namespace yuri {
+  template<typename Input, typename T>
+  using input_t = decltype(std::declval<Input &>().input(std::declval<T &>()));
+
+  // 擦除类型后的Input::input(T &)，缓存在FieldInfo的槽位中按字段分派
+  template<typename Input>
+  using DeserializeFunction = void (*)(Input *input, void *object);
+
+  template<typename Input, typename T>
+  inline void deserializeErased(Input *input, void *object) {
+    input->input(*static_cast<T *>(object));
+  }
+
+  // T不能被Input解析时返回nullptr
+  template<typename Input, typename T>
+  constexpr DeserializeFunction<Input> deserializeFunction() {
+    if constexpr (std::experimental::is_detected_v<input_t, Input, T>) {
+      return &deserializeErased<Input, T>;
+    } else {
+      return nullptr;
+    }
+  }
+}
+
+#endif //LIBYURI_SRC_V2_DESERIALIZEFUNCTION_H_
@@ -0,0 +1,46 @@
+/**
+  * @file   Deserializer.h
+  * @author sora
+  * @date   2026/10/18
+  */
+
+#ifndef LIBYURI_SRC_V2_DESERIALIZER_H_
+#define LIBYURI_SRC_V2_DESERIALIZER_H_
+#include <string_view>
+#include "TypesDef.h"
+namespace yuri {
+
+  template<typename CRTP>
+  class InputBase {
+   public:
+    template<typename T>
+    void input(T &object) {
+      (*static_cast<CRTP *>(this)).input(object);
+    }
+  };
+
+  template<typename Input, typename Source = std::string_view>
+  class Deserializer {
+   protected:
+    Input input;
+   public:
+    template<typename ...Args>
+    explicit Deserializer(Args &&...args): input(std::forward<Args>(args)...) {}
+   public:
+    template<typename T>
+    void deserialize(Source source, T &object) {
+      this->input.reset(source);
+      this->input.input(object);
+      this->input.finish();
+    }
+
+    template<typename T>
+    T deserialize(Source source) {
+      T object{};
+      deserialize(source, object);
+      return object;
+    }
+  };
+}
+
+#endif //LIBYURI_SRC_V2_DESERIALIZER_H_
@@ -0,0 +1,53 @@
+/**
+  * @file   Endian.h
+  * @author sora
+  * @date   2026/10/18
+  */
+
+#ifndef LIBYURI_SRC_V2_ENDIAN_H_
+#define LIBYURI_SRC_V2_ENDIAN_H_
+#include <cstring>
+#include <type_traits>
+#include "TypesDef.h"
+namespace yuri {
+  constexpr bool isLittleEndian = __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+
+  inline u8 byteSwap(u8 value) { return value; }
+  inline u16 byteSwap(u16 value) { return __builtin_bswap16(value); }
+  inline u32 byteSwap(u32 value) { return __builtin_bswap32(value); }
+  inline u64 byteSwap(u64 value) { return __builtin_bswap64(value); }
+
+  template<size_t N>
+  struct UnsignedOfSize;
+  template<>
+  struct UnsignedOfSize<1> { using type = u8; };
+  template<>
+  struct UnsignedOfSize<2> { using type = u16; };
+  template<>
+  struct UnsignedOfSize<4> { using type = u32; };
+  template<>
+  struct UnsignedOfSize<8> { using type = u64; };
+
+  // 以小端字节序读写算术类型
+  template<typename T>
+  inline void storeLittleEndian(char *ptr, T value) {
+    using U = typename UnsignedOfSize<sizeof(T)>::type;
+    U bits;
+    std::memcpy(&bits, &value, sizeof(T));
+    if constexpr (!isLittleEndian) bits = byteSwap(bits);
+    std::memcpy(ptr, &bits, sizeof(T));
+  }
+
+  template<typename T>
+  inline T loadLittleEndian(const char *ptr) {
+    using U = typename UnsignedOfSize<sizeof(T)>::type;
+    U bits;
+    std::memcpy(&bits, ptr, sizeof(T));
+    if constexpr (!isLittleEndian) bits = byteSwap(bits);
+    T value;
+    std::memcpy(&value, &bits, sizeof(T));
+    return value;
+  }
+}
+
+#endif //LIBYURI_SRC_V2_ENDIAN_H_
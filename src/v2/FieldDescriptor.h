@@ -0,0 +1,45 @@
+/**
+  * @file   FieldDescriptor.h
+  * @author sora
+  * @date   2026/10/18
+  */
+
+#ifndef LIBYURI_SRC_V2_FIELDDESCRIPTOR_H_
+#define LIBYURI_SRC_V2_FIELDDESCRIPTOR_H_
+
+#include <string_view>
+#include <type_traits>
+#include "TypeCast.h"
+
+namespace yuri {
+  constexpr size_t MaxFieldCount = 128;
+
+  // ReflectField在类内用重载决议计数：FieldRank<N>可以隐式转换为任意FieldRank<M>(M<N)，
+  // 用FieldRank<MaxFieldCount>调用时会选中已声明的最大编号
+  template<size_t N>
+  struct FieldRank : FieldRank<N - 1> {};
+
+  template<>
+  struct FieldRank<0> {};
+
+  template<size_t I>
+  using FieldIndex = std::integral_constant<size_t, I>;
+
+  template<typename Mp>
+  struct FieldDescriptor {
+    using memberType = memberTypeOfMemberPointer<Mp>;
+    std::string_view name;
+    Mp member;
+    template<typename T>
+    constexpr const memberType &get(const T &object) const { return object.*member; }
+    template<typename T>
+    constexpr memberType &get(T &object) const { return object.*member; }
+  };
+
+  template<typename Mp>
+  constexpr FieldDescriptor<Mp> makeFieldDescriptor(std::string_view name, Mp member) {
+    return FieldDescriptor<Mp>{name, member};
+  }
+}
+
+#endif //LIBYURI_SRC_V2_FIELDDESCRIPTOR_H_
@@ -7,16 +7,44 @@
 #ifndef LIBYURI_SRC_V2_FIELDINFO_H_
 #define LIBYURI_SRC_V2_FIELDINFO_H_
 
+#include <array>
+#include <atomic>
+#include <stdexcept>
+#include <string_view>
 #include "TypeId.h"
 
 namespace yuri {
+  using ErasedFunction = void (*)();
+
+  constexpr size_t MaxBackendCount = 8;
+
+  // 每个按运行期字段表分派的输入后端在FieldInfo::functions中占用一个槽位，第一次使用时分配
+  inline size_t nextBackendSlot() {
+    static std::atomic<size_t> next{0};
+    auto slot = next.fetch_add(1, std::memory_order_relaxed);
+    if (slot >= MaxBackendCount) throw std::logic_error("too many serialize backends");
+    return slot;
+  }
+
+  template<typename Backend>
+  inline size_t backendSlot() {
+    static const size_t slot = nextBackendSlot();
+    return slot;
+  }
+
   struct FieldInfo {
     std::string_view name;
     TypeId id;
     size_t offset;
+    std::array<ErasedFunction, MaxBackendCount> functions{};
     template<typename T>
     bool isTypeOf() const { return isTypeIdOf<T>(id); }
     const void *getFieldPtr(const void *ptr) const { return reinterpret_cast<const char *>(ptr) + offset; }
+    void *getFieldPtr(void *ptr) const { return reinterpret_cast<char *>(ptr) + offset; }
+    template<typename Backend, typename Function>
+    void bindFunction(Function function) { functions[backendSlot<Backend>()] = reinterpret_cast<ErasedFunction>(function); }
+    template<typename Function>
+    Function getFunction(size_t slot) const { return reinterpret_cast<Function>(functions[slot]); }
   };
 }
 
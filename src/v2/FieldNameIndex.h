@@ -0,0 +1,93 @@
+/**
+  * @file   FieldNameIndex.h
+  * @author sora
+  * @date   2026/10/18
+  */
+
+#ifndef LIBYURI_SRC_V2_FIELDNAMEINDEX_H_
+#define LIBYURI_SRC_V2_FIELDNAMEINDEX_H_
+
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+#include "FieldInfo.h"
+#include "TypesDef.h"
+
+namespace yuri {
+  // 字段名到字段下标的只读完美哈希表，字段全部注册后构建一次
+  // 查找时：取名字首尾各8字节作为签名，乘以构建时选出的无冲突种子得到槽位，再比较一次签名
+  class FieldNameIndex {
+    struct Signature {
+      u64 head;
+      u64 tail;
+      bool operator==(const Signature &other) const { return head == other.head && tail == other.tail; }
+    };
+    struct Slot {
+      Signature signature;
+      std::string_view name;
+      size_t field;
+    };
+    std::vector<Slot> slots;
+    u64 seed = 0;
+    u32 shift = 64;
+   private:
+    template<typename U>
+    static U load(const char *ptr) {
+      U value;
+      std::memcpy(&value, ptr, sizeof(value));
+      return value;
+    }
+    // 长度不超过16的名字，签名和长度可以唯一确定名字本身；更长的名字用整体哈希作为后半部分
+    static Signature signatureOf(std::string_view name) {
+      auto ptr = name.data();
+      auto size = name.size();
+      if (size > 16) return Signature{load<u64>(ptr), std::hash<std::string_view>()(name)};
+      if (size >= 8) return Signature{load<u64>(ptr), load<u64>(ptr + size - 8) ^ size};
+      if (size >= 4) return Signature{load<u32>(ptr), load<u32>(ptr + size - 4) ^ size};
+      if (size > 0) return Signature{u64(u8(ptr[0])) | u64(u8(ptr[size / 2])) << 8u | u64(u8(ptr[size - 1])) << 16u, size};
+      return Signature{0, 0};
+    }
+    size_t slotOf(const Signature &signature) const {
+      return shift == 64 ? 0 : ((signature.head ^ (signature.tail * 0x9E3779B97F4A7C15ull)) * seed) >> shift;
+    }
+   public:
+    static constexpr size_t npos = size_t(-1);
+
+    void build(const std::vector<FieldInfo> &fields) {
+      slots.clear();
+      if (fields.empty()) return;
+      u32 bits = 1;
+      while ((size_t(1) << bits) < fields.size() * 2) ++bits;
+      u64 candidate = 0x2545F4914F6CDD1Dull;
+      for (size_t attempt = 1;; ++attempt) {
+        candidate = candidate * 6364136223846793005ull + 1442695040888963407ull;
+        seed = candidate | 1u;
+        shift = 64 - bits;
+        slots.assign(size_t(1) << bits, Slot{Signature{0, 0}, std::string_view(), npos});
+        bool collision = false;
+        for (size_t i = 0; i < fields.size() && !collision; ++i) {
+          auto signature = signatureOf(fields[i].name);
+          auto &slot = slots[slotOf(signature)];
+          collision = slot.field != npos;
+          slot = Slot{signature, fields[i].name, i};
+        }
+        if (!collision) return;
+        // 多次尝试仍有冲突时把表扩大一倍
+        if (attempt % 64 == 0 && ++bits > 24) throw std::logic_error("can not build field name index");
+      }
+    }
+
+    size_t find(std::string_view name) const {
+      if (slots.empty()) return npos;
+      auto signature = signatureOf(name);
+      auto &slot = slots[slotOf(signature)];
+      if (!(slot.signature == signature) || slot.name.size() != name.size()) return npos;
+      if (name.size() > 16 && std::memcmp(slot.name.data(), name.data(), name.size()) != 0) return npos;
+      return slot.field;
+    }
+  };
+}
+
+#endif //LIBYURI_SRC_V2_FIELDNAMEINDEX_H_
@@ -0,0 +1,264 @@
+/**
+  * @file   IterativeJsonSerializer.h
+  * @author sora
+  * @date   2026/10/18
+  */
+
+#ifndef LIBYURI_SRC_V2_ITERATIVEJSONSERIALIZER_H_
+#define LIBYURI_SRC_V2_ITERATIVEJSONSERIALIZER_H_
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include "JsonSerializer.h"
+
+namespace yuri {
+
+  template<typename T>
+  class Reflectable;
+
+  // 放不进帧中的迭代器存放在这里，按栈的顺序分配和释放
+  // 空间按块分配，已有的块不会搬移，在多次输出之间复用
+  class FrameArena {
+    struct Block {
+      std::unique_ptr<std::max_align_t[]> data;
+      size_t size;
+    };
+    std::vector<Block> blocks;
+    size_t block = 0;
+    size_t used = 0;
+   public:
+    // 分配前的位置，release时回到这里
+    struct Mark {
+      size_t block;
+      size_t used;
+    };
+
+    Mark mark() const { return Mark{block, used}; }
+
+    void *allocate(size_t size, size_t align) {
+      for (;; ++block, used = 0) {
+        if (block == blocks.size()) {
+          auto count = (std::max(size, size_t(4096)) + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+          blocks.push_back(Block{std::make_unique<std::max_align_t[]>(count), count * sizeof(std::max_align_t)});
+        }
+        auto offset = (used + align - 1) / align * align;
+        if (offset + size <= blocks[block].size) {
+          used = offset + size;
+          return reinterpret_cast<unsigned char *>(blocks[block].data.get()) + offset;
+        }
+      }
+    }
+
+    void release(Mark to) {
+      block = to.block;
+      used = to.used;
+    }
+  };
+
+  // 输出与JsonOutput相同，但不递归：对象、数组和pair压入显式的栈，逐步输出
+  // 嵌套深度只受内存限制，栈在多次输出之间复用
+  class IterativeJsonOutput : public JsonOutput {
+    struct Frame {
+      // 输出下一部分，输出完毕时返回false；self是该帧的下标，压栈后引用会失效
+      bool (*step)(IterativeJsonOutput &out, size_t self);
+      // 中途抛出异常时销毁帧持有的迭代器，不需要时为空
+      void (*unwind)(IterativeJsonOutput &out, Frame &frame);
+      const void *object;
+      // 对象中下一个字段的下标，数组、pair中已经输出的元素个数
+      size_t index;
+      // 数组的当前迭代器和结束迭代器，放不进时存放它们在arena中的位置
+      alignas(void *) unsigned char state[4 * sizeof(void *)];
+    };
+    std::vector<Frame> stack;
+    FrameArena arena;
+
+    template<typename T>
+    static auto reflectableType(const Reflectable<T> *) -> T;
+    static auto reflectableType(...) -> void;
+    // T继承的Reflectable<X>中的X，不是Reflectable时为void
+    template<typename T>
+    using ReflectableTypeOf = decltype(reflectableType(std::declval<const T *>()));
+
+    // 可以按字节随vector扩容一起搬移的迭代器直接放在帧中，其余的放在arena中
+    template<typename Iterator>
+    static constexpr bool fitsFrame = sizeof(Iterator) * 2 <= sizeof(Frame::state)
+        && alignof(Iterator) <= alignof(void *)
+        && std::is_trivially_copyable_v<Iterator> && std::is_trivially_destructible_v<Iterator>;
+
+    struct ArenaIterators {
+      void *data;
+      FrameArena::Mark mark;
+    };
+
+    // 输出对象的第I个字段，每个类型有一张按字段下标索引的函数表
+    using FieldOutput = void (*)(IterativeJsonOutput &out, const void *object);
+
+    template<typename T, size_t I>
+    static void fieldOutput(IterativeJsonOutput &out, const void *object) {
+      constexpr auto field = Reflectable<T>::template field<I>();
+      out.nameOutput(field.name);
+      out.value(field.get(*static_cast<const T *>(object)));
+    }
+
+    template<typename T, size_t ...I>
+    static constexpr std::array<FieldOutput, sizeof...(I)> makeFieldOutputs(std::index_sequence<I...>) {
+      return {fieldOutput<T, I>...};
+    }
+
+    template<typename T>
+    static constexpr auto fieldOutputs = makeFieldOutputs<T>(std::make_index_sequence<Reflectable<T>::fieldCount()>{});
+
+   private:
+    template<typename T>
+    static bool objectStep(IterativeJsonOutput &out, size_t self) {
+      auto &frame = out.stack[self];
+      if (frame.index == Reflectable<T>::fieldCount()) {
+        out.buffer.put('}');
+        return false;
+      }
+      auto i = frame.index++;
+      if (i != 0) out.buffer.put(',');
+      fieldOutputs<T>[i](out, frame.object);
+      return true;
+    }
+
+    // 当前迭代器和结束迭代器依次存放
+    template<typename Iterator>
+    static Iterator *iterators(Frame &frame) {
+      if constexpr (fitsFrame<Iterator>) {
+        return std::launder(reinterpret_cast<Iterator *>(frame.state));
+      } else {
+        return static_cast<Iterator *>(std::launder(reinterpret_cast<ArenaIterators *>(frame.state))->data);
+      }
+    }
+
+    template<typename Iterator>
+    static void releaseIterators(IterativeJsonOutput &out, Frame &frame) {
+      auto slot = *std::launder(reinterpret_cast<ArenaIterators *>(frame.state));
+      auto it = static_cast<Iterator *>(slot.data);
+      it[1].~Iterator();
+      it[0].~Iterator();
+      out.arena.release(slot.mark);
+    }
+
+    template<typename T>
+    static bool listStep(IterativeJsonOutput &out, size_t self) {
+      using Iterator = decltype(std::declval<const T &>().begin());
+      auto &frame = out.stack[self];
+      auto it = iterators<Iterator>(frame);
+      if (it[0] == it[1]) {
+        out.buffer.put(']');
+        if constexpr (!fitsFrame<Iterator>) releaseIterators<Iterator>(out, frame);
+        return false;
+      }
+      if (frame.index++ != 0) out.buffer.put(',');
+      // 先移动迭代器，输出元素时可能压栈
+      auto &&element = *it[0];
+      ++it[0];
+      out.value(element);
+      return true;
+    }
+
+    template<typename T>
+    static bool pairStep(IterativeJsonOutput &out, size_t self) {
+      const auto &pair = *static_cast<const T *>(out.stack[self].object);
+      switch (out.stack[self].index++) {
+        case 0:out.buffer.write(R"({"1":)");
+          out.value(pair.first);
+          return true;
+        case 1:out.buffer.write(R"(,"2":)");
+          out.value(pair.second);
+          return true;
+        default:out.buffer.put('}');
+          return false;
+      }
+    }
+
+    // 出错时按出栈顺序销毁残留帧的迭代器，栈和arena留给下一次输出
+    void unwind() {
+      while (!stack.empty()) {
+        if (stack.back().unwind != nullptr) stack.back().unwind(*this, stack.back());
+        stack.pop_back();
+      }
+      arena.release(FrameArena::Mark{0, 0});
+    }
+
+    // 标量直接输出，对象、数组和pair只压栈
+    void value(const char *str) {
+      stringOutput(str);
+    }
+
+    template<typename T>
+    void value(T *const ptr) {
+      if (ptr == nullptr) {
+        buffer.write("null");
+      } else {
+        value(*ptr);
+      }
+    }
+
+    template<typename T>
+    void value(const std::shared_ptr<T> &ptr) {
+      value(ptr.get());
+    }
+
+    template<typename T>
+    void value(const std::unique_ptr<T> &ptr) {
+      value(ptr.get());
+    }
+
+    template<typename K, typename V>
+    void value(const std::pair<K, V> &pair) {
+      stack.push_back(Frame{pairStep<std::pair<K, V>>, nullptr, &pair, 0, {}});
+    }
+
+    template<typename T>
+    void value(const T &object) {
+      if constexpr (std::is_convertible_v<const T &, std::string_view>) {
+        stringOutput(object);
+      } else if constexpr (!std::is_void_v<ReflectableTypeOf<T>>) {
+        using Object = ReflectableTypeOf<T>;
+        buffer.put('{');
+        stack.push_back(Frame{objectStep<Object>, nullptr, static_cast<const Object *>(&object), 0, {}});
+      } else if constexpr (is_range_v<T>) {
+        using Iterator = decltype(std::declval<const T &>().begin());
+        buffer.put('[');
+        if constexpr (fitsFrame<Iterator>) {
+          auto &frame = stack.emplace_back(Frame{listStep<T>, nullptr, &object, 0, {}});
+          new(frame.state) Iterator(object.begin());
+          new(frame.state + sizeof(Iterator)) Iterator(object.end());
+        } else {
+          static_assert(alignof(Iterator) <= alignof(std::max_align_t), "over-aligned iterator");
+          auto mark = arena.mark();
+          auto data = static_cast<Iterator *>(arena.allocate(2 * sizeof(Iterator), alignof(Iterator)));
+          new(data) Iterator(object.begin());
+          new(data + 1) Iterator(object.end());
+          auto &frame = stack.emplace_back(Frame{listStep<T>, releaseIterators<Iterator>, &object, 0, {}});
+          new(frame.state) ArenaIterators{data, mark};
+        }
+      } else {
+        JsonOutput::output(object);
+      }
+    }
+   public:
+    template<typename T>
+    void output(const T &object) {
+      struct Guard {
+        IterativeJsonOutput &out;
+        ~Guard() { out.unwind(); }
+      } guard{*this};
+      value(object);
+      while (!stack.empty()) {
+        auto self = stack.size() - 1;
+        if (!stack[self].step(*this, self)) stack.pop_back();
+      }
+    }
+  };
+
+  using IterativeJsonSerializer = Serializer<IterativeJsonOutput>;
+}
+
+#endif //LIBYURI_SRC_V2_ITERATIVEJSONSERIALIZER_H_
@@ -0,0 +1,365 @@
+/**
+  * @file   JsonDeserializer.h
+  * @author sora
+  * @date   2026/10/18
+  */
+
+#ifndef LIBYURI_SRC_V2_JSONDESERIALIZER_H_
+#define LIBYURI_SRC_V2_JSONDESERIALIZER_H_
+#include <charconv>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include "Deserializer.h"
+#include "TypeTraits/RangeTrait.h"
+#include "TypeTraits/InsertTrait.h"
+#include "DeserializeFunction.h"
+
+namespace yuri {
+
+  template<typename T>
+  class Reflectable;
+
+  class JsonInput : public InputBase<JsonInput> {
+    const char *begin = nullptr;
+    const char *cur = nullptr;
+    const char *end = nullptr;
+    std::string keyBuffer;
+   private:
+    template<typename T>
+    static constexpr bool inputable = std::experimental::is_detected_v<input_t, JsonInput, T>;
+
+    [[noreturn]] void error(const std::string &what) const {
+      throw std::runtime_error("json parse error: " + what + " at offset " + std::to_string(cur - begin));
+    }
+
+    static bool isSpace(char c) {
+      return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    void skipSpace() {
+      while (cur != end && isSpace(*cur)) ++cur;
+    }
+
+    char peek() {
+      skipSpace();
+      return cur == end ? '\0' : *cur;
+    }
+
+    bool consume(char c) {
+      if (peek() != c) return false;
+      ++cur;
+      return true;
+    }
+
+    void expect(char c) {
+      if (!consume(c)) error(std::string(1, c) + " expected");
+    }
+
+    bool consumeLiteral(std::string_view literal) {
+      skipSpace();
+      if (static_cast<size_t>(end - cur) < literal.size() || std::memcmp(cur, literal.data(), literal.size()) != 0) {
+        return false;
+      }
+      cur += literal.size();
+      return true;
+    }
+
+    static void appendUtf8(std::string &out, unsigned code) {
+      if (code < 0x80) {
+        out.push_back(static_cast<char>(code));
+      } else if (code < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+        out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+      } else if (code < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+      } else {
+        out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+      }
+    }
+
+    unsigned hex4() {
+      if (end - cur < 4) error("bad unicode escape");
+      unsigned code = 0;
+      for (int i = 0; i < 4; ++i, ++cur) {
+        char c = *cur;
+        code <<= 4u;
+        if (c >= '0' && c <= '9') code |= c - '0';
+        else if (c >= 'a' && c <= 'f') code |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') code |= c - 'A' + 10;
+        else error("bad unicode escape");
+      }
+      return code;
+    }
+
+    // 从反斜杠处开始解码，直到字符串结束，cur停在右引号之后
+    void unescapeTail(std::string &out) {
+      while (true) {
+        const char *run = cur;
+        while (cur != end && *cur != '"' && *cur != '\\') ++cur;
+        out.append(run, cur - run);
+        if (cur == end) error("unterminated string");
+        if (*cur++ == '"') return;
+        if (cur == end) error("unterminated string");
+        switch (*cur++) {
+          case '"':out.push_back('"');
+            break;
+          case '\\':out.push_back('\\');
+            break;
+          case '/':out.push_back('/');
+            break;
+          case 'b':out.push_back('\b');
+            break;
+          case 'f':out.push_back('\f');
+            break;
+          case 'n':out.push_back('\n');
+            break;
+          case 'r':out.push_back('\r');
+            break;
+          case 't':out.push_back('\t');
+            break;
+          case 'u': {
+            unsigned code = hex4();
+            if (code >= 0xD800 && code < 0xDC00 && end - cur >= 6 && cur[0] == '\\' && cur[1] == 'u') {
+              cur += 2;
+              unsigned low = hex4();
+              if (low < 0xDC00 || low >= 0xE000) error("bad surrogate pair");
+              code = 0x10000 + ((code - 0xD800) << 10u) + (low - 0xDC00);
+            }
+            appendUtf8(out, code);
+            break;
+          }
+          default:error("bad escape");
+        }
+      }
+    }
+
+    // 没有转义字符时直接返回输入中的视图，否则解码到buffer中
+    std::string_view readString(std::string &buffer) {
+      expect('"');
+      const char *start = cur;
+      while (cur != end && *cur != '"' && *cur != '\\') ++cur;
+      if (cur == end) error("unterminated string");
+      if (*cur == '"') {
+        return std::string_view(start, cur++ - start);
+      }
+      buffer.assign(start, cur - start);
+      unescapeTail(buffer);
+      return buffer;
+    }
+
+    void skipString() {
+      expect('"');
+      while (cur != end && *cur != '"') {
+        if (*cur == '\\' && ++cur == end) break;
+        ++cur;
+      }
+      if (cur == end) error("unterminated string");
+      ++cur;
+    }
+
+    void skipValue() {
+      switch (peek()) {
+        case '"':skipString();
+          return;
+        case '{':
+        case '[': {
+          size_t depth = 0;
+          do {
+            switch (peek()) {
+              case '"':skipString();
+                continue;
+              case '{':
+              case '[':++depth;
+                break;
+              case '}':
+              case ']':--depth;
+                break;
+              case '\0':error("unterminated value");
+              default:break;
+            }
+            ++cur;
+          } while (depth != 0);
+          return;
+        }
+        default: {
+          const char *start = cur;
+          while (cur != end && !isSpace(*cur) && *cur != ',' && *cur != '}' && *cur != ']') ++cur;
+          if (cur == start) error("value expected");
+        }
+      }
+    }
+
+    // 按JSON的数字语法 -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)? 找到数字的结尾
+    // from_chars还接受inf、nan和前导零，所以先检查
+    const char *numberEnd() const {
+      auto p = cur;
+      auto digit = [&] { return p != end && static_cast<unsigned char>(*p - '0') < 10; };
+      auto digits = [&] {
+        if (!digit()) error("number expected");
+        while (digit()) ++p;
+      };
+      if (p != end && *p == '-') ++p;
+      if (p != end && *p == '0') {
+        ++p;
+        if (digit()) error("leading zero in number");
+      } else {
+        digits();
+      }
+      if (p != end && *p == '.') {
+        ++p;
+        digits();
+      }
+      if (p != end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        if (p != end && (*p == '+' || *p == '-')) ++p;
+        digits();
+      }
+      return p;
+    }
+
+    template<typename T>
+    void numberInput(T &number) {
+      skipSpace();
+      auto last = numberEnd();
+      auto[ptr, ec] = std::from_chars(cur, last, number);
+      if (ec == std::errc::result_out_of_range) error("number out of range");
+      if (ec != std::errc() || ptr != last) error("number expected");
+      cur = ptr;
+    }
+
+    template<typename T, typename Create>
+    void pointerInput(T &ptr, Create create) {
+      if (consumeLiteral("null")) {
+        ptr = nullptr;
+        return;
+      }
+      if (ptr == nullptr) ptr = create();
+      input(*ptr);
+    }
+   public:
+    void reset(std::string_view str) {
+      begin = cur = str.data();
+      end = begin + str.size();
+    }
+
+    void finish() {
+      if (peek() != '\0') error("trailing characters");
+    }
+
+    void input(bool &b) {
+      if (consumeLiteral("true")) {
+        b = true;
+      } else if (consumeLiteral("false")) {
+        b = false;
+      } else {
+        error("bool expected");
+      }
+    }
+
+    template<typename T, typename Enable = std::enable_if_t<std::is_integral_v<T> || std::is_floating_point_v<T>>>
+    void input(T &number) {
+      numberInput(number);
+    }
+
+    void input(std::string &str) {
+      expect('"');
+      const char *start = cur;
+      while (cur != end && *cur != '"' && *cur != '\\') ++cur;
+      if (cur == end) error("unterminated string");
+      str.assign(start, cur - start);
+      if (*cur++ == '\\') {
+        --cur;
+        unescapeTail(str);
+      }
+    }
+
+    template<typename T, typename Enable = std::enable_if_t<inputable<T>>>
+    void input(T *&ptr) {
+      pointerInput(ptr, []() { return new T(); });
+    }
+
+    template<typename T, typename Enable = std::enable_if_t<inputable<T>>>
+    void input(std::shared_ptr<T> &ptr) {
+      pointerInput(ptr, []() { return std::make_shared<T>(); });
+    }
+
+    template<typename T, typename Enable = std::enable_if_t<inputable<T>>>
+    void input(std::unique_ptr<T> &ptr) {
+      pointerInput(ptr, []() { return std::make_unique<T>(); });
+    }
+
+    template<typename K, typename V, typename Enable = std::enable_if_t<inputable<K> && inputable<V>>>
+    void input(std::pair<K, V> &pair) {
+      expect('{');
+      if (consume('}')) return;
+      do {
+        auto key = readString(keyBuffer);
+        expect(':');
+        if (key == "1") {
+          input(pair.first);
+        } else if (key == "2") {
+          input(pair.second);
+        } else {
+          skipValue();
+        }
+      } while (consume(','));
+      expect('}');
+    }
+
+    template<typename T, typename Enable = std::enable_if_t<is_range_v<T>
+        && is_insertable_v<T>
+        && inputable<mutable_value_t<typename T::value_type>>>, typename _Place = void>
+    void input(T &list) {
+      expect('[');
+      list.clear();
+      if (consume(']')) return;
+      do {
+        mutable_value_t<typename T::value_type> value{};
+        input(value);
+        list.insert(list.end(), std::move(value));
+      } while (consume(','));
+      expect(']');
+    }
+
+    template<typename T>
+    void input(Reflectable<T> &reflectable) {
+      using Function = DeserializeFunction<JsonInput>;
+      const auto slot = backendSlot<JsonInput>();
+      expect('{');
+      if (consume('}')) return;
+      auto &list = reflectable.getFieldInfoList();
+      size_t hint = 0;
+      do {
+        auto key = readString(keyBuffer);
+        expect(':');
+        // 字段通常按声明顺序出现，先与上一个字段的下一个比较，不匹配时再查索引
+        const FieldInfo *field = nullptr;
+        if (hint < list.size() && list[hint].name == key) {
+          field = &list[hint];
+        } else {
+          field = reflectable.getFieldInfo(key);
+        }
+        if (field == nullptr) {
+          skipValue();
+          continue;
+        }
+        hint = field - list.data() + 1;
+        auto function = field->getFunction<Function>(slot);
+        if (function == nullptr) error("field type can not be deserialized");
+        function(this, field->getFieldPtr(&reflectable));
+      } while (consume(','));
+      expect('}');
+    }
+  };
+
+  using JsonDeserializer = Deserializer<JsonInput>;
+}
+
+#endif //LIBYURI_SRC_V2_JSONDESERIALIZER_H_
@@ -0,0 +1,137 @@
+/**
+  * @file   JsonEscape.h
+  * @author sora
+  * @date   2026/10/18
+  */
+
+#ifndef LIBYURI_SRC_V2_JSONESCAPE_H_
+#define LIBYURI_SRC_V2_JSONESCAPE_H_
+#include <string_view>
+#include "OutputBuffer.h"
+#include "TypesDef.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define YURI_JSON_ESCAPE_X86 1
+#endif
+
+namespace yuri {
+  namespace detail {
+    // 引号、反斜杠和小于0x20的控制字符需要转义
+    inline bool needsEscape(char c) {
+      return c == '"' || c == '\\' || static_cast<u8>(c) < 0x20;
+    }
+
+    inline void escapeChar(OutputBuffer &buffer, char c) {
+      switch (c) {
+        case '"':buffer.write("\\\"", 2);
+          break;
+        case '\\':buffer.write("\\\\", 2);
+          break;
+        case '\b':buffer.write("\\b", 2);
+          break;
+        case '\f':buffer.write("\\f", 2);
+          break;
+        case '\n':buffer.write("\\n", 2);
+          break;
+        case '\r':buffer.write("\\r", 2);
+          break;
+        case '\t':buffer.write("\\t", 2);
+          break;
+        default: {
+          constexpr char hex[] = "0123456789abcdef";
+          char escaped[] = {'\\', 'u', '0', '0', hex[static_cast<u8>(c) >> 4u], hex[static_cast<u8>(c) & 0xFu]};
+          buffer.write(escaped, sizeof(escaped));
+        }
+      }
+    }
+
+    // 从str[begin]开始逐字节处理到结尾，连续的无需转义的部分整段写入
+    inline void escapeScalar(OutputBuffer &buffer, const char *str, size_t size, size_t begin) {
+      size_t run = begin;
+      for (size_t i = begin; i < size; ++i) {
+        if (needsEscape(str[i])) {
+          buffer.write(str + run, i - run);
+          escapeChar(buffer, str[i]);
+          run = i + 1;
+        }
+      }
+      buffer.write(str + run, size - run);
+    }
+
+    inline void escapeJsonScalar(OutputBuffer &buffer, const char *str, size_t size) {
+      escapeScalar(buffer, str, size, 0);
+    }
+
+#ifdef YURI_JSON_ESCAPE_X86
+    // 每次检查16字节，没有需要转义的字符时整块写入，否则只写到第一个需要转义的字符为止
+    __attribute__((target("sse2")))
+    inline void escapeJsonSse2(OutputBuffer &buffer, const char *str, size_t size) {
+      const __m128i quote = _mm_set1_epi8('"');
+      const __m128i backslash = _mm_set1_epi8('\\');
+      const __m128i control = _mm_set1_epi8(0x1F);
+      size_t i = 0;
+      while (i + 16 <= size) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(str + i));
+        __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                                    _mm_cmpeq_epi8(_mm_max_epu8(chunk, control), control));
+        auto mask = static_cast<u32>(_mm_movemask_epi8(hits));
+        if (mask == 0) {
+          buffer.write(str + i, 16);
+          i += 16;
+        } else {
+          auto hit = static_cast<size_t>(__builtin_ctz(mask));
+          buffer.write(str + i, hit);
+          escapeChar(buffer, str[i + hit]);
+          i += hit + 1;
+        }
+      }
+      escapeScalar(buffer, str, size, i);
+    }
+
+    __attribute__((target("avx2")))
+    inline void escapeJsonAvx2(OutputBuffer &buffer, const char *str, size_t size) {
+      const __m256i quote = _mm256_set1_epi8('"');
+      const __m256i backslash = _mm256_set1_epi8('\\');
+      const __m256i control = _mm256_set1_epi8(0x1F);
+      size_t i = 0;
+      while (i + 32 <= size) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(str + i));
+        __m256i hits = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote),
+                                                       _mm256_cmpeq_epi8(chunk, backslash)),
+                                       _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, control), control));
+        auto mask = static_cast<u32>(_mm256_movemask_epi8(hits));
+        if (mask == 0) {
+          buffer.write(str + i, 32);
+          i += 32;
+        } else {
+          auto hit = static_cast<size_t>(__builtin_ctz(mask));
+          buffer.write(str + i, hit);
+          escapeChar(buffer, str[i + hit]);
+          i += hit + 1;
+        }
+      }
+      escapeScalar(buffer, str, size, i);
+    }
+#endif
+
+    using EscapeFunction = void (*)(OutputBuffer &, const char *, size_t);
+
+    // 运行时根据CPU支持的指令集选择实现
+    inline EscapeFunction selectEscapeFunction() {
+#ifdef YURI_JSON_ESCAPE_X86
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx2")) return &escapeJsonAvx2;
+      if (__builtin_cpu_supports("sse2")) return &escapeJsonSse2;
+#endif
+      return &escapeJsonScalar;
+    }
+  }
+
+  // 把str转义后写入buffer，不包括两侧的引号
+  inline void escapeJsonString(OutputBuffer &buffer, std::string_view str) {
+    static const detail::EscapeFunction escape = detail::selectEscapeFunction();
+    escape(buffer, str.data(), str.size());
+  }
+}
+
+#endif //LIBYURI_SRC_V2_JSONESCAPE_H_
@@ -6,11 +6,13 @@
 
 #ifndef LIBYURI_SRC_V2_JSONSERIALIZER_H_
 #define LIBYURI_SRC_V2_JSONSERIALIZER_H_
+#include <cmath>
 #include <memory>
 #include "Serializer.h"
+#include "JsonEscape.h"
 #include "TypeTraits/RangeTrait.h"
-#include "SerializeFunctionMap.h"
 #include "TypeTraits/OutputStreamOverloadTraits.h"
+#include "TypeTraits/NumberTrait.h"
 
 namespace yuri {
 
@@ -18,23 +20,28 @@ namespace yuri {
   class Reflectable;
 
   class JsonOutput : public OutputBase<JsonOutput, std::string> {
-    std::stringstream ss;
-   private:
-    template<typename T>
-    void stringOutput(const T &str) {
-      ss << '"' << str << '"';
+   protected:
+    void stringOutput(std::string_view str) {
+      buffer.put('"');
+      escapeJsonString(buffer, str);
+      buffer.put('"');
     }
+    // 字段名是标识符，不需要转义
+    void nameOutput(std::string_view name) {
+      buffer.put('"');
+      buffer.write(name);
+      buffer.write("\":", 2);
+    }
+   private:
     template<typename T>
     void listOutput(const T &list) {
-      ss << '[';
-      bool atLeastWriteOnce = false;
+      buffer.put('[');
+      bool first = true;
       for (auto &&elem : list) {
-        atLeastWriteOnce = true;
+        buffer.separate(first);
         output(elem);
-        ss << ',';
       }
-      if (atLeastWriteOnce)ss.seekp(-1, std::ios::cur);
-      ss << ']';
+      buffer.put(']');
     }
    public:
     void output(std::string_view str) {
@@ -51,7 +58,7 @@ namespace yuri {
     template<typename T>
     void output(T *const ptr) {
       if (ptr == nullptr) {
-        ss << "null";
+        buffer.write("null");
       } else {
         output(*ptr);
       }
@@ -69,11 +76,11 @@ namespace yuri {
 
     template<typename K, typename V>
     void output(const std::pair<K, V> &pair) {
-      ss << R"({"1":)";
+      buffer.write(R"({"1":)");
       output(pair.first);
-      ss << R"(,"2":)";
+      buffer.write(R"(,"2":)");
       output(pair.second);
-      ss << '}';
+      buffer.put('}');
     }
 
     template<typename T, typename Enable = std::enable_if_t<is_range_v<T>>>
@@ -83,28 +90,39 @@ namespace yuri {
 
     template<typename T>
     void output(const Reflectable<T> &reflectable) {
-      ss << '{';
-      bool atLeastWriteOnce = false;
-      for (auto &&info : reflectable.getFieldInfoList()) {
-        if (info.offset >= sizeof(T))break;
-        atLeastWriteOnce = true;
-        stringOutput(info.name);
-        ss << ':';
-        SerializeFunctionMap<JsonOutput>::getInstance().getSerializeFunction(info.id)(this,
-                                                                                      info.getFieldPtr(&reflectable));
-        ss << ',';
-      }
-      if (atLeastWriteOnce) ss.seekp(-1, std::ios::cur);
-      ss << '}';
+      const auto &object = static_cast<const T &>(reflectable);
+      buffer.put('{');
+      bool first = true;
+      Reflectable<T>::forEachField([&](auto field) {
+        buffer.separate(first);
+        nameOutput(field.name);
+        output(field.get(object));
+      });
+      buffer.put('}');
     }
 
     template<typename T, typename Enable = std::enable_if_t<is_outputstream_overload<T>>, typename _Place = void>
     void output(const T &object) {
-      ss << object;
+      if constexpr (std::is_same_v<T, bool>) {
+        buffer.write(object ? "true" : "false");
+      } else if constexpr (std::is_floating_point_v<T>) {
+        // JSON不能表示inf和nan
+        if (std::isfinite(object)) {
+          buffer.writeNumber(object);
+        } else {
+          buffer.write("null");
+        }
+      } else if constexpr (is_number_v<T>) {
+        buffer.writeNumber(object);
+      } else if constexpr (std::is_enum_v<T>) {
+        buffer.writeNumber(static_cast<std::underlying_type_t<T>>(object));
+      } else {
+        streamOutput(object);
+      }
     }
 
     std::string toResult() {
-      return ss.str();
+      return buffer.release();
     }
   };
 
@@ -0,0 +1,138 @@
+/**
+  * @file   OutputBuffer.h
+  * @author sora
+  * @date   2026/10/18
+  */
+
+#ifndef LIBYURI_SRC_V2_OUTPUTBUFFER_H_
+#define LIBYURI_SRC_V2_OUTPUTBUFFER_H_
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include "OutputSink.h"
+namespace yuri {
+  // 只追加的字节缓冲区，存储就是结果的std::string，release()时整个移出，不拷贝
+  // data.size()是可写空间，length是已写入的长度；按倍数扩容，新空间只在扩容时零初始化一次
+  // 设置了sink时缓冲区大小固定，写满后先把已有内容交给sink
+  class OutputBuffer {
+    std::string data;
+    size_t length = 0;
+    // 上一次release()的长度，移出存储后第一次扩容直接扩到这么大，复用的Serializer不必每次从64字节重新扩容
+    size_t lastSize = 0;
+    OutputSink *sink = nullptr;
+    size_t flushed = 0;
+   private:
+    void reallocate(size_t n) {
+      // 先截到已写入的长度，扩容时只搬移有效内容
+      data.resize(length);
+      data.resize(n);
+    }
+    void grow(size_t n) {
+      if (sink != nullptr) {
+        flush();
+        if (data.size() >= n) return;
+      }
+      reallocate(std::max({data.size() * 2, length + n, lastSize, size_t(64)}));
+    }
+   public:
+    void setSink(OutputSink *target, size_t bufferSize) {
+      sink = target;
+      bufferSize = std::max(bufferSize, size_t(64));
+      if (data.size() < bufferSize) reallocate(bufferSize);
+    }
+
+    // 把缓冲区中的内容交给sink
+    void flush() {
+      if (sink == nullptr || length == 0) return;
+      sink->write(data.data(), length);
+      flushed += length;
+      length = 0;
+    }
+
+    // 返回上次调用后交给sink的总字节数
+    size_t takeFlushed() {
+      return std::exchange(flushed, 0);
+    }
+
+    void reserve(size_t n) {
+      if (data.size() < n) reallocate(n);
+    }
+
+    size_t size() const { return length; }
+
+    bool empty() const { return length == 0; }
+
+    std::string_view view() const { return std::string_view(data.data(), length); }
+
+    // 保留已分配的空间
+    void clear() { length = 0; }
+
+    void put(char c) {
+      if (length == data.size()) grow(1);
+      data[length++] = c;
+    }
+
+    void write(const char *str, size_t n) {
+      // 大块数据不经过缓冲区，直接交给sink
+      if (sink != nullptr && n >= data.size()) {
+        flush();
+        sink->write(str, n);
+        flushed += n;
+        return;
+      }
+      if (data.size() - length < n) grow(n);
+      std::memcpy(&data[length], str, n);
+      length += n;
+    }
+
+    void write(std::string_view str) {
+      write(str.data(), str.size());
+    }
+
+    // 获取至少n字节的可写空间，写完后调用commit提交实际写入的长度
+    char *claim(size_t n) {
+      if (data.size() - length < n) grow(n);
+      return &data[0] + length;
+    }
+
+    void commit(size_t n) {
+      length += n;
+    }
+
+    // 用std::to_chars直接写入缓冲区，浮点数使用可往返的最短表示
+    template<typename T>
+    void writeNumber(T value) {
+      // 整数：位数+符号；浮点数：最短表示不超过max_digits10位有效数字+符号、小数点和指数
+      constexpr size_t maxLength = std::is_integral_v<T> ? std::numeric_limits<T>::digits10 + 2
+                                                         : std::numeric_limits<T>::max_digits10 + 12;
+      char *first = claim(maxLength);
+      auto result = std::to_chars(first, first + maxLength, value);
+      commit(result.ptr - first);
+    }
+
+    // 除第一次调用外，每次写入一个分隔符
+    void separate(bool &first, char separator = ',') {
+      if (first) {
+        first = false;
+      } else {
+        put(separator);
+      }
+    }
+
+    // 截掉未写入的部分后把存储移出作为结果
+    std::string release() {
+      data.resize(length);
+      lastSize = length;
+      length = 0;
+      std::string result;
+      result.swap(data);
+      return result;
+    }
+  };
+}
+
+#endif //LIBYURI_SRC_V2_OUTPUTBUFFER_H_
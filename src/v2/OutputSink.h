@@ -0,0 +1,72 @@
+/**
+  * @file   OutputSink.h
+  * @author sora
+  * @date   2026/10/18
+  */
+
+#ifndef LIBYURI_SRC_V2_OUTPUTSINK_H_
+#define LIBYURI_SRC_V2_OUTPUTSINK_H_
+#include <cerrno>
+#include <cstdio>
+#include <ostream>
+#include <stdexcept>
+#include <system_error>
+#include <unistd.h>
+
+namespace yuri {
+  // 序列化结果的去向，OutputBuffer写满时把已有内容交给sink
+  class OutputSink {
+   public:
+    virtual ~OutputSink() = default;
+    virtual void write(const char *data, size_t n) = 0;
+    virtual void flush() {}
+  };
+
+  class FdSink : public OutputSink {
+    int fd;
+   public:
+    explicit FdSink(int fd) : fd(fd) {}
+
+    void write(const char *data, size_t n) override {
+      while (n != 0) {
+        auto written = ::write(fd, data, n);
+        if (written < 0) {
+          if (errno == EINTR) continue;
+          throw std::system_error(errno, std::generic_category(), "write failed");
+        }
+        data += written;
+        n -= written;
+      }
+    }
+  };
+
+  class FileSink : public OutputSink {
+    FILE *file;
+   public:
+    explicit FileSink(FILE *file) : file(file) {}
+
+    void write(const char *data, size_t n) override {
+      if (std::fwrite(data, 1, n, file) != n) throw std::runtime_error("fwrite failed");
+    }
+
+    void flush() override {
+      if (std::fflush(file) != 0) throw std::runtime_error("fflush failed");
+    }
+  };
+
+  class OstreamSink : public OutputSink {
+    std::ostream &stream;
+   public:
+    explicit OstreamSink(std::ostream &stream) : stream(stream) {}
+
+    void write(const char *data, size_t n) override {
+      if (!stream.write(data, static_cast<std::streamsize>(n))) throw std::runtime_error("ostream write failed");
+    }
+
+    void flush() override {
+      if (!stream.flush()) throw std::runtime_error("ostream flush failed");
+    }
+  };
+}
+
+#endif //LIBYURI_SRC_V2_OUTPUTSINK_H_
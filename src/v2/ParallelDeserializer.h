@@ -0,0 +1,226 @@
+/**
+  * @file   ParallelDeserializer.h
+  * @author sora
+  * @date   2026/10/18
+  */
+
+#ifndef LIBYURI_SRC_V2_PARALLELDESERIALIZER_H_
+#define LIBYURI_SRC_V2_PARALLELDESERIALIZER_H_
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+#include "BatchSerializer.h"
+#include "JsonDeserializer.h"
+#include "ThreadPool.h"
+#include "TypesDef.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace yuri {
+  // 把NDJSON或JSON数组按记录边界切开，由线程池并行解析成std::vector<T>
+  template<typename T>
+  class ParallelDeserializer {
+    static constexpr size_t ChunksPerThread = 4;
+    ThreadPool pool;
+    BatchFormat format;
+   private:
+    static bool isSpace(char c) {
+      return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    static std::string_view trim(std::string_view str) {
+      while (!str.empty() && isSpace(str.front())) str.remove_prefix(1);
+      while (!str.empty() && isSpace(str.back())) str.remove_suffix(1);
+      return str;
+    }
+
+    // 解析一条记录，错误信息中的偏移量换算成整个输入中的位置
+    static void parseRecord(JsonInput &input, std::string_view all, std::string_view record, T &object) {
+      try {
+        input.reset(record);
+        input.input(object);
+        input.finish();
+      } catch (const std::runtime_error &e) {
+        throw std::runtime_error(std::string(e.what()) + " in record at offset "
+                                     + std::to_string(record.data() - all.data()));
+      }
+    }
+
+    // 从pos开始的下一行的起点
+    static size_t nextLine(std::string_view str, size_t pos) {
+      if (pos == 0 || pos >= str.size()) return std::min(pos, str.size());
+      auto newline = str.find('\n', pos - 1);
+      return newline == std::string_view::npos ? str.size() : newline + 1;
+    }
+
+    std::vector<T> deserializeLines(std::string_view str) {
+      // 按字节均分，再把每个切点推到下一行的开头，JSON字符串中不会出现未转义的换行
+      size_t count = std::min(pool.size() * ChunksPerThread, std::max<size_t>(str.size() / 4096, 1));
+      std::vector<std::vector<T>> parts(count);
+      pool.run(count, [&](size_t i) {
+        size_t begin = nextLine(str, str.size() * i / count);
+        size_t end = nextLine(str, str.size() * (i + 1) / count);
+        JsonInput input;
+        while (begin < end) {
+          auto newline = str.find('\n', begin);
+          if (newline == std::string_view::npos || newline > end) newline = end;
+          auto line = trim(str.substr(begin, newline - begin));
+          if (!line.empty()) parseRecord(input, str, line, parts[i].emplace_back());
+          begin = newline + 1;
+        }
+      });
+      size_t total = 0;
+      for (auto &part : parts) total += part.size();
+      std::vector<T> result;
+      result.reserve(total);
+      for (auto &part : parts) {
+        std::move(part.begin(), part.end(), std::back_inserter(result));
+      }
+      return result;
+    }
+
+    // 64字节中各类字符的位图，超出str的部分不属于任何一类
+    struct BlockMasks {
+      u64 quote;
+      u64 backslash;
+      u64 open;
+      u64 close;
+      u64 comma;
+    };
+
+    static BlockMasks classify(std::string_view str, size_t off) {
+      const char *block = str.data() + off;
+      char padded[64] = {};
+      if (str.size() - off < 64) {
+        std::memcpy(padded, block, str.size() - off);
+        block = padded;
+      }
+      BlockMasks masks{0, 0, 0, 0, 0};
+#if defined(__SSE2__)
+      for (int i = 0; i < 4; ++i) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i * 16));
+        auto bits = [&](char c) {
+          auto hits = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(c)));
+          return static_cast<u64>(static_cast<u16>(hits)) << (i * 16);
+        };
+        masks.quote |= bits('"');
+        masks.backslash |= bits('\\');
+        masks.open |= bits('{') | bits('[');
+        masks.close |= bits('}') | bits(']');
+        masks.comma |= bits(',');
+      }
+#else
+      for (int i = 0; i < 64; ++i) {
+        auto bit = u64(1) << i;
+        switch (block[i]) {
+          case '"':masks.quote |= bit;
+            break;
+          case '\\':masks.backslash |= bit;
+            break;
+          case '{':
+          case '[':masks.open |= bit;
+            break;
+          case '}':
+          case ']':masks.close |= bit;
+            break;
+          case ',':masks.comma |= bit;
+            break;
+          default:break;
+        }
+      }
+#endif
+      return masks;
+    }
+
+    // 每次分类64字节，用前缀异或算出字符串内的字节，只逐个检查字符串外的括号和逗号
+    // 括号深度在整块内都不会回到0时直接按个数累加，找出顶层数组中每个元素的范围
+    static std::vector<std::string_view> splitArray(std::string_view str) {
+      std::vector<std::string_view> elements;
+      size_t i = 0;
+      auto fail = [&](const char *what) {
+        throw std::runtime_error(std::string("json parse error: ") + what + " at offset " + std::to_string(i));
+      };
+      while (i < str.size() && isSpace(str[i])) ++i;
+      if (i == str.size() || str[i] != '[') fail("[ expected");
+      size_t start = ++i;
+      size_t depth = 0;
+      u64 inString = 0;
+      u64 escapeNext = 0;
+      for (size_t pos = start; pos < str.size(); pos += 64) {
+        auto masks = classify(str, pos);
+        // 被转义的字符，反斜杠通常很少，逐个处理
+        u64 escaped = escapeNext;
+        escapeNext = 0;
+        for (u64 bs = masks.backslash & ~escaped; bs != 0; bs &= bs - 1) {
+          auto bit = bs & -bs;
+          if (bit == u64(1) << 63) {
+            escapeNext = 1;
+          } else {
+            escaped |= bit << 1;
+            // 被转义的反斜杠不再转义下一个字符
+            bs &= ~(bit << 1);
+          }
+        }
+        // 字符串内的字节（包括开头的引号，不包括结尾的引号）为1
+        u64 inside = masks.quote & ~escaped;
+        for (int shift = 1; shift < 64; shift <<= 1) inside ^= inside << shift;
+        inside ^= inString;
+        inString = static_cast<u64>(static_cast<i64>(inside) >> 63);
+        u64 open = masks.open & ~inside;
+        u64 close = masks.close & ~inside;
+        if (static_cast<size_t>(__builtin_popcountll(close)) < depth) {
+          depth += __builtin_popcountll(open) - __builtin_popcountll(close);
+          continue;
+        }
+        for (u64 structural = open | close | (masks.comma & ~inside); structural != 0; structural &= structural - 1) {
+          auto bit = structural & -structural;
+          i = pos + __builtin_ctzll(bit);
+          if (open & bit) {
+            ++depth;
+          } else if (depth != 0 && (close & bit)) {
+            --depth;
+          } else if (depth == 0 && (str[i] == ',' || str[i] == ']')) {
+            auto element = trim(str.substr(start, i - start));
+            if (element.empty() && (str[i] == ',' || !elements.empty())) fail("value expected");
+            if (!element.empty()) elements.push_back(element);
+            start = i + 1;
+            if (str[i] == ']') {
+              if (!trim(str.substr(i + 1)).empty()) fail("trailing characters");
+              return elements;
+            }
+          }
+        }
+      }
+      i = str.size();
+      fail(inString != 0 ? "unterminated string" : "unterminated array");
+      return elements;
+    }
+
+    std::vector<T> deserializeArray(std::string_view str) {
+      auto elements = splitArray(str);
+      // 元素个数已知，各线程直接写入结果中自己的区间
+      std::vector<T> result(elements.size());
+      size_t count = std::min(pool.size() * ChunksPerThread, elements.size());
+      pool.run(count, [&](size_t i) {
+        JsonInput input;
+        for (size_t j = elements.size() * i / count, end = elements.size() * (i + 1) / count; j < end; ++j) {
+          parseRecord(input, str, elements[j], result[j]);
+        }
+      });
+      return result;
+    }
+   public:
+    explicit ParallelDeserializer(BatchFormat format = BatchFormat::Lines,
+                                  size_t threads = std::thread::hardware_concurrency())
+        : pool(threads), format(format) {}
+
+    // 解析失败时抛出std::runtime_error，偏移量是出错记录在str中的位置
+    std::vector<T> deserialize(std::string_view str) {
+      return format == BatchFormat::Lines ? deserializeLines(str) : deserializeArray(str);
+    }
+  };
+}
+
+#endif //LIBYURI_SRC_V2_PARALLELDESERIALIZER_H_
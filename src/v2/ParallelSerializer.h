@@ -0,0 +1,112 @@
+/**
+  * @file   ParallelSerializer.h
+  * @author sora
+  * @date   2026/10/18
+  */
+
+#ifndef LIBYURI_SRC_V2_PARALLELSERIALIZER_H_
+#define LIBYURI_SRC_V2_PARALLELSERIALIZER_H_
+#include <cerrno>
+#include <climits>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <sys/uio.h>
+#include "BatchSerializer.h"
+#include "ThreadPool.h"
+
+namespace yuri {
+  // 把一组记录切成若干段，由线程池并行序列化到各段自己的缓冲区，再按原顺序拼接
+  template<typename Output = JsonOutput>
+  class ParallelSerializer {
+    // 段数多于线程数，记录长短不一时负载更均衡
+    static constexpr size_t ChunksPerThread = 4;
+    ThreadPool pool;
+    BatchFormat format;
+    std::vector<BatchOutput<Output>> chunks;
+    // 本次使用的段数
+    size_t used = 0;
+   private:
+    template<typename Range>
+    void serializeChunks(const Range &records) {
+      auto begin = std::begin(records);
+      size_t count = std::size(records);
+      used = std::min(chunks.size(), count);
+      pool.run(used, [&](size_t i) {
+        auto &output = chunks[i];
+        auto &buffer = output.getBuffer();
+        buffer.clear();
+        auto first = begin + count * i / used;
+        auto last = begin + count * (i + 1) / used;
+        bool firstRecord = true;
+        for (auto it = first; it != last; ++it) {
+          if (format == BatchFormat::Array) buffer.separate(firstRecord);
+          output.output(*it);
+          if (format == BatchFormat::Lines) buffer.put('\n');
+        }
+      });
+    }
+
+    // 按顺序调用f(view)，数组格式在各段之间补上括号和逗号
+    template<typename F>
+    void forEachPiece(F &&f) const {
+      if (format == BatchFormat::Array) f(std::string_view("["));
+      for (size_t i = 0; i < used; ++i) {
+        if (format == BatchFormat::Array && i != 0) f(std::string_view(","));
+        f(chunks[i].getBuffer().view());
+      }
+      if (format == BatchFormat::Array) f(std::string_view("]"));
+    }
+   public:
+    explicit ParallelSerializer(BatchFormat format = BatchFormat::Lines,
+                                size_t threads = std::thread::hardware_concurrency())
+        : pool(threads), format(format), chunks(pool.size() * ChunksPerThread) {}
+
+    // 拼接成一个字符串，只做一次拷贝；records需要支持随机访问
+    template<typename Range>
+    std::string serialize(const Range &records) {
+      serializeChunks(records);
+      size_t total = 0;
+      forEachPiece([&](std::string_view piece) { total += piece.size(); });
+      std::string result;
+      result.reserve(total);
+      forEachPiece([&](std::string_view piece) { result.append(piece); });
+      return result;
+    }
+
+    // 用writev把各段直接写入fd，不拼接，返回写入的字节数
+    template<typename Range>
+    size_t write(int fd, const Range &records) {
+      serializeChunks(records);
+      std::vector<iovec> pieces;
+      size_t total = 0;
+      forEachPiece([&](std::string_view piece) {
+        if (piece.empty()) return;
+        pieces.push_back(iovec{const_cast<char *>(piece.data()), piece.size()});
+        total += piece.size();
+      });
+      size_t index = 0;
+      while (index < pieces.size()) {
+        auto count = static_cast<int>(std::min<size_t>(pieces.size() - index, IOV_MAX));
+        auto written = ::writev(fd, pieces.data() + index, count);
+        if (written < 0) {
+          if (errno == EINTR) continue;
+          throw std::system_error(errno, std::generic_category(), "writev failed");
+        }
+        // 跳过已经写完的部分，部分写入的iovec调整起点
+        auto left = static_cast<size_t>(written);
+        while (index < pieces.size() && left >= pieces[index].iov_len) {
+          left -= pieces[index++].iov_len;
+        }
+        if (left != 0) {
+          pieces[index].iov_base = static_cast<char *>(pieces[index].iov_base) + left;
+          pieces[index].iov_len -= left;
+        }
+      }
+      return total;
+    }
+  };
+}
+
+#endif //LIBYURI_SRC_V2_PARALLELSERIALIZER_H_
@@ -7,17 +7,19 @@
 #ifndef LIBYURI_SRC_V2_REFLECTINFO_H_
 #define LIBYURI_SRC_V2_REFLECTINFO_H_
 
+#include <unordered_map>
+#include <vector>
 #include "FieldInfo.h"
+#include "FieldNameIndex.h"
 namespace yuri {
+  // 只由Reflectable<T>在第一次访问时构造一次，之后只读
   template<typename T>
   struct ReflectInfo {
     std::vector<FieldInfo> fieldInfoList{};
-    std::unordered_map<std::string_view, TypeId> nameToTypeId{};
-    std::unordered_map<size_t, TypeId> offsetToTypeId{};
-    std::unordered_map<std::string_view, size_t> nameToOffset{};
-    static ReflectInfo<T> &getInstance() {
-      static ReflectInfo<T> ins{};
-      return ins;
+    FieldNameIndex nameIndex{};
+    const FieldInfo *findField(std::string_view name) const {
+      auto index = nameIndex.find(name);
+      return index == FieldNameIndex::npos ? nullptr : &fieldInfoList[index];
     }
   };
 }
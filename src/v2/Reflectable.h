@@ -15,13 +15,39 @@
 #include "TypeCast.h"
 #include "UniqueVariable.h"
 #include "RegisterConfig.h"
+#include "FieldDescriptor.h"
 namespace yuri {
   template<typename T>
   class Reflectable {
     // Type Info Storage
    private:
-    static ReflectInfo<T> &reflectInfo() {
-      return ReflectInfo<T>::getInstance();
+    static const ReflectInfo<T> &reflectInfo() {
+      static const ReflectInfo<T> info = buildReflectInfo();
+      return info;
+    }
+    // 第一次访问时才由编译期字段表生成运行期信息
+    static ReflectInfo<T> buildReflectInfo() {
+      ReflectInfo<T> info;
+      forEachField([&info](auto field) { addField(info, field.name, field.member); });
+      info.nameIndex.build(info.fieldInfoList);
+      return info;
+    }
+    template<typename Mp>
+    static void addField(ReflectInfo<T> &reflectInfo, std::string_view name, Mp member) {
+      using memberType = memberTypeOfMemberPointer<Mp>;
+      auto offset = memberToOffset(member);
+      auto id = typeId<memberType>();
+      FieldInfo info{name, id, offset};
+      inputRegister<memberType>(info);
+      reflectInfo.fieldInfoList.emplace_back(info);
+    }
+    template<typename F, size_t ...I>
+    static constexpr void forEachField(F &&f, std::index_sequence<I...>) {
+      (f(T::_yuriField(FieldIndex<I>{})), ...);
+    }
+    template<typename F, size_t ...I>
+    static constexpr void visitField(size_t i, F &&f, std::index_sequence<I...>) {
+      ((i == I && (f(T::_yuriField(FieldIndex<I>{})), true)) || ...);
     }
     T &toSubclass() { return *static_cast<T *>(this); }
     const T &toSubclass() const { return *static_cast<T *>(this); }
@@ -29,28 +55,35 @@ namespace yuri {
    protected:
     using baseType = Reflectable<T>;
     using selfType = T;
-    template<typename Mp>
-    static bool addField(std::string_view name, Mp member) noexcept {
-      outputRegister<T>();
-      using memberType = memberTypeOfMemberPointer<Mp>;
-      auto offset = memberToOffset(member);
-      auto id = typeId<memberType>;
-      reflectInfo().fieldInfoList.emplace_back(FieldInfo{name, id, offset});
-      reflectInfo().nameToTypeId[name] = id;
-      reflectInfo().offsetToTypeId[offset] = id;
-      reflectInfo().nameToOffset[name] = offset;
-      outputRegister<memberType>();
-      return true;
+    static auto _yuriFieldCount(FieldRank<0>) -> FieldIndex<0>;
+   public:
+    static constexpr size_t fieldCount() {
+      return decltype(T::_yuriFieldCount(FieldRank<MaxFieldCount>{}))::value;
+    }
+    // 按声明顺序对每个字段的FieldDescriptor调用f，整个遍历在编译期展开
+    template<typename F>
+    static constexpr void forEachField(F &&f) {
+      forEachField(f, std::make_index_sequence<fieldCount()>{});
+    }
+    // 对第i个字段的FieldDescriptor调用f，i在运行期给出
+    template<typename F>
+    static constexpr void visitField(size_t i, F &&f) {
+      visitField(i, f, std::make_index_sequence<fieldCount()>{});
+    }
+    // 第I个字段的FieldDescriptor
+    template<size_t I>
+    static constexpr auto field() {
+      return T::_yuriField(FieldIndex<I>{});
     }
    public:
     Reflectable() = default;
     const auto &getFieldInfoList() const { return reflectInfo().fieldInfoList; }
     template<typename Member>
     Member &getFieldByName(std::string_view name) {
-      if (auto it = reflectInfo().nameToOffset.find(name); it == reflectInfo().nameToOffset.end()) {
+      if (auto info = reflectInfo().findField(name); info == nullptr) {
         throw std::runtime_error("access unknown field");
       } else {
-        return getFieldByOffset<Member>(it->second);
+        return getFieldByOffset<Member>(info->offset);
       }
     }
     template<typename Member>
@@ -58,7 +91,10 @@ namespace yuri {
       return toSubclass().*(offsetToMember<T, Member>(offset));
     }
     bool hasField(std::string_view name) const {
-      return reflectInfo().nameToTypeId.find(name) != reflectInfo().nameToTypeId.end();
+      return reflectInfo().findField(name) != nullptr;
+    }
+    static const FieldInfo *getFieldInfo(std::string_view name) {
+      return reflectInfo().findField(name);
     }
     std::string toString() const {
       return StringSerializer().serialize(*this);
@@ -68,6 +104,14 @@ namespace yuri {
 }
 
 #define ReflectField(name, ...) name __VA_ARGS__ ; \
- private: inline static bool _unique_var = (baseType::addField(#name, &selfType::name)); public:
+ private: \
+  static constexpr size_t _yuri_index_##name = decltype(_yuriFieldCount(yuri::FieldRank<yuri::MaxFieldCount>{}))::value; \
+  static_assert(_yuri_index_##name < yuri::MaxFieldCount, "too many reflect fields"); \
+  static auto _yuriFieldCount(yuri::FieldRank<_yuri_index_##name + 1>) -> yuri::FieldIndex<_yuri_index_##name + 1>; \
+  static constexpr auto _yuriField(yuri::FieldIndex<_yuri_index_##name>) { \
+    return yuri::makeFieldDescriptor(#name, &selfType::name); \
+  } \
+  friend baseType; \
+ public:
 
 #endif //LIBYURI_SRC_V2_REFLECTABLE_H_
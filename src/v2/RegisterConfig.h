@@ -8,11 +8,15 @@
 #define LIBYURI_SRC_V2_REGISTERCONFIG_H_
 #include "JsonSerializer.h"
 #include "StringSerializer.h"
+#include "JsonDeserializer.h"
+#include "BinarySerializer.h"
+#include "BinaryDeserializer.h"
 namespace yuri {
+  // 按运行期字段表分派的后端在这里把函数指针缓存到字段的槽位中
+  // 输出后端和BinaryInput在编译期展开字段，不需要注册
   template<typename T>
-  inline void outputRegister() {
-    SerializeFunctionMap<StringOutput>::getInstance().registerSerializeFunction<T>();
-    SerializeFunctionMap<JsonOutput>::getInstance().registerSerializeFunction<T>();
+  inline void inputRegister(FieldInfo &info) {
+    info.bindFunction<JsonInput>(deserializeFunction<JsonInput, T>());
   }
 }
 #endif //LIBYURI_SRC_V2_REGISTERCONFIG_H_
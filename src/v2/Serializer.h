@@ -6,17 +6,40 @@
 
 #ifndef LIBYURI_SRC_V2_SERIALIZER_H_
 #define LIBYURI_SRC_V2_SERIALIZER_H_
+#include <memory>
+#include <sstream>
 #include "TypesDef.h"
+#include "OutputBuffer.h"
+#include "OutputSink.h"
 namespace yuri {
 
   template<typename CRTP, typename Result>
   class OutputBase {
+    std::unique_ptr<std::ostringstream> stream;
+   protected:
+    OutputBuffer buffer;
+    // 仅用于只重载了operator<<的类型
+    template<typename T>
+    std::string streamString(const T &object) {
+      if (stream == nullptr) {
+        stream = std::make_unique<std::ostringstream>();
+      } else {
+        stream->str(std::string());
+      }
+      *stream << object;
+      return stream->str();
+    }
+    template<typename T>
+    void streamOutput(const T &object) {
+      buffer.write(streamString(object));
+    }
    public:
     template<typename T>
     void output(const T &object) {
       (*static_cast<CRTP *>(this)).output(object);
     }
-    Result toResult() { (*static_cast<CRTP *>(this)).toResult(); }
+    void reserve(size_t n) { buffer.reserve(n); }
+    Result toResult() { return (*static_cast<CRTP *>(this)).toResult(); }
   };
 
   template<typename Output, typename Result = std::string>
@@ -27,6 +50,10 @@ namespace yuri {
     template<typename ...Args>
     explicit Serializer(Args &&...args): output(std::forward<Args>(args)...) {}
    public:
+    void reserve(size_t n) {
+      this->output.reserve(n);
+    }
+
     template<typename T>
     Result serialize(const T &object) {
       this->output.output(object);
@@ -34,6 +61,25 @@ namespace yuri {
     }
 
   };
+
+  // 边序列化边写入sink，内存占用只有固定大小的缓冲区，结果是写入的字节数
+  template<typename Output>
+  class SinkOutput : public Output {
+    OutputSink &sink;
+   public:
+    explicit SinkOutput(OutputSink &sink, size_t bufferSize = 64 * 1024) : sink(sink) {
+      this->buffer.setSink(&sink, bufferSize);
+    }
+
+    size_t toResult() {
+      this->buffer.flush();
+      sink.flush();
+      return this->buffer.takeFlushed();
+    }
+  };
+
+  template<typename Output>
+  using SinkSerializer = Serializer<SinkOutput<Output>, size_t>;
 }
 
 #endif //LIBYURI_SRC_V2_SERIALIZER_H_
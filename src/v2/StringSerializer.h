@@ -10,7 +10,7 @@
 #include "Serializer.h"
 #include "TypeTraits/RangeTrait.h"
 #include "TypeTraits/OutputStreamOverloadTraits.h"
-#include "SerializeFunctionMap.h"
+#include "TypeTraits/NumberTrait.h"
 #include <list>
 #include <memory>
 
@@ -20,23 +20,22 @@ namespace yuri {
   class Reflectable;
 
   class StringOutput : public OutputBase<StringOutput, std::string> {
-    std::stringstream ss;
    private:
     template<typename T>
     void stringOutput(const T &str) {
-      ss << '"' << str << '"';
+      buffer.put('"');
+      buffer.write(str);
+      buffer.put('"');
     }
     template<typename T>
     void listOutput(const T &list) {
-      ss << '[';
-      bool atLeastWriteOnce = false;
+      buffer.put('[');
+      bool first = true;
       for (auto &&elem : list) {
-        atLeastWriteOnce = true;
+        buffer.separate(first);
         output(elem);
-        ss << ',';
       }
-      if (atLeastWriteOnce)ss.seekp(-1, std::ios::cur);
-      ss << ']';
+      buffer.put(']');
     }
    public:
 
@@ -54,9 +53,9 @@ namespace yuri {
     template<typename T>
     void output(T *const ptr) {
       if (ptr == nullptr) {
-        ss << "null";
+        buffer.write("null");
       } else {
-        ss << '&';
+        buffer.put('&');
         output(*ptr);
       }
     }
@@ -73,11 +72,11 @@ namespace yuri {
 
     template<typename K, typename V>
     void output(const std::pair<K, V> &pair) {
-      ss << '<';
+      buffer.put('<');
       output(pair.first);
-      ss << ':';
+      buffer.put(':');
       output(pair.second);
-      ss << '>';
+      buffer.put('>');
     }
 
     template<typename T, typename Enable = std::enable_if_t<is_range_v<T>>>
@@ -87,27 +86,33 @@ namespace yuri {
 
     template<typename T>
     void output(const Reflectable<T> &reflectable) {
-      ss << '{';
-      bool atLeastWriteOnce = false;
-      for (auto &&info : reflectable.getFieldInfoList()) {
-        if (info.offset >= sizeof(T))break;
-        atLeastWriteOnce = true;
-        ss << info.name << '=';
-        SerializeFunctionMap<StringOutput>::getInstance().getSerializeFunction(info.id)(this,
-                                                                                        info.getFieldPtr(&reflectable));
-        ss << ',';
-      }
-      if (atLeastWriteOnce) ss.seekp(-1, std::ios::cur);
-      ss << '}';
+      const auto &object = static_cast<const T &>(reflectable);
+      buffer.put('{');
+      bool first = true;
+      Reflectable<T>::forEachField([&](auto field) {
+        buffer.separate(first);
+        buffer.write(field.name);
+        buffer.put('=');
+        output(field.get(object));
+      });
+      buffer.put('}');
     }
 
     template<typename T, typename Enable = std::enable_if_t<is_outputstream_overload<T>>, typename _Place = void>
     void output(const T &object) {
-      ss << object;
+      if constexpr (std::is_same_v<T, bool>) {
+        buffer.write(object ? "true" : "false");
+      } else if constexpr (is_number_v<T>) {
+        buffer.writeNumber(object);
+      } else if constexpr (std::is_enum_v<T>) {
+        buffer.writeNumber(static_cast<std::underlying_type_t<T>>(object));
+      } else {
+        streamOutput(object);
+      }
     }
 
     std::string toResult() {
-      return ss.str();
+      return buffer.release();
     }
   };
 
@@ -0,0 +1,122 @@
+/**
+  * @file   ThreadPool.h
+  * @author sora
+  * @date   2026/10/18
+  */
+
+#ifndef LIBYURI_SRC_V2_THREADPOOL_H_
+#define LIBYURI_SRC_V2_THREADPOOL_H_
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "TypesDef.h"
+
+namespace yuri {
+  // fork-join线程池：run()把[0, count)分给所有线程（包括调用线程），全部完成后返回
+  class ThreadPool {
+    using Job = std::function<void(size_t)>;
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    const Job *job = nullptr;
+    size_t jobCount = 0;
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> remaining{0};
+    // 正在执行work()的工作线程数，run()在它们全部退出后才会修改任务
+    size_t active = 0;
+    u64 generation = 0;
+    bool stop = false;
+    std::exception_ptr error;
+   private:
+    void work(const Job &f, size_t count) {
+      while (true) {
+        size_t i = next.fetch_add(1, std::memory_order_relaxed);
+        if (i >= count) return;
+        try {
+          f(i);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (error == nullptr) error = std::current_exception();
+        }
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+          std::lock_guard<std::mutex> lock(mutex);
+          idle.notify_all();
+        }
+      }
+    }
+
+    void loop() {
+      u64 seen = 0;
+      std::unique_lock<std::mutex> lock(mutex);
+      while (true) {
+        wake.wait(lock, [&]() { return stop || generation != seen; });
+        if (stop) return;
+        seen = generation;
+        const Job *f = job;
+        size_t count = jobCount;
+        // run()已经结束时醒来的线程没有任务可做
+        if (f == nullptr) continue;
+        ++active;
+        lock.unlock();
+        work(*f, count);
+        lock.lock();
+        if (--active == 0) idle.notify_all();
+      }
+    }
+   public:
+    // threads包括调用run()的线程
+    explicit ThreadPool(size_t threads = std::thread::hardware_concurrency()) {
+      for (size_t i = 1; i < std::max<size_t>(threads, 1); ++i) {
+        workers.emplace_back([this]() { loop(); });
+      }
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    ~ThreadPool() {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+      }
+      wake.notify_all();
+      for (auto &worker : workers) worker.join();
+    }
+
+    size_t size() const { return workers.size() + 1; }
+
+    // 对[0, count)中的每个i调用f(i)，任务抛出的第一个异常在这里重新抛出
+    void run(size_t count, const Job &f) {
+      if (count == 0) return;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        idle.wait(lock, [&]() { return active == 0; });
+        job = &f;
+        jobCount = count;
+        next.store(0, std::memory_order_relaxed);
+        remaining.store(count, std::memory_order_relaxed);
+        error = nullptr;
+        ++generation;
+      }
+      wake.notify_all();
+      work(f, count);
+      std::exception_ptr failure;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        idle.wait(lock, [&]() { return remaining.load(std::memory_order_acquire) == 0 && active == 0; });
+        job = nullptr;
+        failure = std::exchange(error, nullptr);
+      }
+      if (failure != nullptr) std::rethrow_exception(failure);
+    }
+  };
+}
+
+#endif //LIBYURI_SRC_V2_THREADPOOL_H_
@@ -6,23 +6,35 @@
 
 #ifndef LIBYURI_SRC_V2_TYPEID_H_
 #define LIBYURI_SRC_V2_TYPEID_H_
+#include <atomic>
+#include <cstdint>
 
 namespace yuri {
 
-  using TypeId = const void*;
+  // 从0开始连续分配的类型编号，可以直接作为分发表的下标
+  using TypeId = uint32_t;
+
+  inline TypeId nextTypeId() {
+    static std::atomic<TypeId> next{0};
+    return next.fetch_add(1, std::memory_order_relaxed);
+  }
 
   template<typename T>
   struct TypeIdGenerator {
-    static void id() {}
-    inline static const auto Id = reinterpret_cast<TypeId>(&TypeIdGenerator<T>::id);
+    static TypeId id() {
+      static const TypeId Id = nextTypeId();
+      return Id;
+    }
   };
 
   template <typename T>
-  inline TypeId typeId = TypeIdGenerator<T>::Id;
+  inline TypeId typeId() {
+    return TypeIdGenerator<T>::id();
+  }
 
   template <typename T>
   inline bool isTypeIdOf(TypeId id) {
-    return id == typeId<T>;
+    return id == typeId<T>();
   }
 
 }
@@ -0,0 +1,30 @@
+/**
+  * @file   ContiguousTrait.h
+  * @author sora
+  * @date   2026/10/18
+  */
+
+#ifndef LIBYURI_SRC_V2_TYPETRAITS_CONTIGUOUSTRAIT_H_
+#define LIBYURI_SRC_V2_TYPETRAITS_CONTIGUOUSTRAIT_H_
+#include <array>
+#include <type_traits>
+#include <vector>
+namespace yuri {
+  // 元素为算术类型且在内存中连续存放的容器，可以整块拷贝
+  template<typename T>
+  constexpr bool is_block_element_v = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
+  template<typename T>
+  struct IsContiguousArithmetic : std::false_type {};
+
+  template<typename T, typename Allocator>
+  struct IsContiguousArithmetic<std::vector<T, Allocator>> : std::bool_constant<is_block_element_v<T>> {};
+
+  template<typename T, size_t N>
+  struct IsContiguousArithmetic<std::array<T, N>> : std::bool_constant<is_block_element_v<T>> {};
+
+  template<typename T>
+  constexpr bool is_contiguous_arithmetic_v = IsContiguousArithmetic<T>::value;
+}
+
+#endif //LIBYURI_SRC_V2_TYPETRAITS_CONTIGUOUSTRAIT_H_
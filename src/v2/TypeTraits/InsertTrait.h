@@ -0,0 +1,35 @@
+/**
+  * @file   InsertTrait.h
+  * @author sora
+  * @date   2026/10/18
+  */
+
+#ifndef LIBYURI_SRC_V2_TYPETRAITS_INSERTTRAIT_H_
+#define LIBYURI_SRC_V2_TYPETRAITS_INSERTTRAIT_H_
+#include <utility>
+#include <type_traits>
+#include <experimental/type_traits>
+namespace yuri {
+  template<typename T>
+  using insert_t = decltype(std::declval<T &>().insert(std::declval<T &>().end(),
+                                                       std::declval<typename T::value_type>()));
+
+  template<typename T>
+  constexpr bool is_insertable_v = std::experimental::is_detected_v<insert_t, T>;
+
+  // map的value_type是pair<const K, V>，需要先解析到pair<K, V>再插入
+  template<typename T>
+  struct MutableValue {
+    using type = std::remove_cv_t<T>;
+  };
+
+  template<typename K, typename V>
+  struct MutableValue<std::pair<K, V>> {
+    using type = std::pair<std::remove_cv_t<K>, V>;
+  };
+
+  template<typename T>
+  using mutable_value_t = typename MutableValue<T>::type;
+}
+
+#endif //LIBYURI_SRC_V2_TYPETRAITS_INSERTTRAIT_H_
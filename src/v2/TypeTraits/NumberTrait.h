@@ -0,0 +1,22 @@
+/**
+  * @file   NumberTrait.h
+  * @author sora
+  * @date   2026/10/18
+  */
+
+#ifndef LIBYURI_SRC_V2_TYPETRAITS_NUMBERTRAIT_H_
+#define LIBYURI_SRC_V2_TYPETRAITS_NUMBERTRAIT_H_
+#include <type_traits>
+
+namespace yuri {
+  // 按数字输出的算术类型，bool和字符类型除外
+  template<typename T>
+  constexpr bool is_number_v = std::is_arithmetic_v<T>
+      && !std::is_same_v<T, bool>
+      && !std::is_same_v<T, char>
+      && !std::is_same_v<T, wchar_t>
+      && !std::is_same_v<T, char16_t>
+      && !std::is_same_v<T, char32_t>;
+}
+
+#endif //LIBYURI_SRC_V2_TYPETRAITS_NUMBERTRAIT_H_
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <memory>
-#include "yuri.h"
+#include <memory_resource>
+#include "src/deprecated/yuri.h"
 
 using namespace std;
 
@@ -22,6 +23,8 @@ struct Tree {
 };
 
 int main() {
+  // 类型都已注册，之后的查找走排序数组
+  reflect::freeze();
   Tree<int> t;
   t.root = make_shared<Node<int>>(17);
   t.root->left = make_shared<Node<int>>(26);
@@ -29,16 +32,40 @@ int main() {
   t.root->left->left = make_shared<Node<int>>(42);
   t.root->left->right = make_shared<Node<int>>(47);
   t.root->right->left = make_shared<Node<int>>(49);
-  auto str = reflect::reflect_default_serialize(t);
+  auto str = reflect::dumps(t);
   cout << str << endl;
-  auto t2 = reflect::reflect_default_deserialize<Tree<int>>(str);
-  cout << reflect::reflect_default_serialize(t2) << endl;
-  std::any parse;
+  auto t2 = reflect::json::reflect_default_deserialize<Tree<int>>(str);
+  cout << reflect::dumps(t2) << endl;
+  // 所有节点从同一块缓冲区分配，缓冲区析构时一次释放
+  {
+    std::pmr::monotonic_buffer_resource arena;
+    auto t4 = reflect::json::reflect_default_deserialize<Tree<int>>(str, &arena);
+    cout << reflect::dumps(t4) << endl;
+  }
+  // 分段输入，模拟从socket陆续收到的数据
+  Tree<int> t3;
+  reflect::PushParser parser(t3);
+  for (size_t i = 0; i < str.size(); i += 16) {
+    parser.feed(std::string_view(str).substr(i, 16));
+  }
+  if (parser.finish()) cout << reflect::dumps(t3) << endl;
+  // 只需要其中几个值时按路径取出，其余部分直接跳过
+  int data = 0;
+  if (reflect::json::extract(str, "root/data", data)) cout << data << endl;
+  std::string_view paths[] = {"root/left/data", "root/right/left"}, values[2];
+  if (reflect::json::find_paths(str, paths, 2, values)) cout << values[0] << ' ' << values[1] << endl;
+  // 不知道类型时解析成Document
+  reflect::Document doc(str);
+  cout << doc.root()["root"]["data"].as_int64() << endl;
+  for (auto member : doc.root()["root"]["left"].members()) {
+    cout << member.key << (member.value().is_object() ? " object" : "") << endl;
+  }
+  // 同一块缓冲区写入长度相同的新内容后再解析，不能沿用上一次的分类结果
+  std::string buffer = R"({"root":{"data":1}}  )";
+  Tree<int> first, second;
   size_t off = 0;
-  using Object = unordered_map<string, any>;
-  reflect::Deserializer::parse_unknown_field(str, off, &parse);
-  auto &obj = any_cast<Object &>(parse);
-  auto &root = any_cast<Object &>(obj["root"]);
-  auto data = any_cast<double>(root["data"]);
-  cout << data << endl;
+  if (!reflect::json::deserialize<Tree<int>>(buffer, off, &first)) return 1;
+  buffer = R"({ "root": {"data":2}})";
+  off = 0;
+  if (!reflect::json::deserialize<Tree<int>>(buffer, off, &second) || second.root->data != 2) return 1;
 }
\ No newline at end of file